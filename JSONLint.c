@@ -42,38 +42,67 @@
 #include <stdbool.h>
 #include <string.h>
 #include "JSONLint.h"
-
+#include "JSONLintScan.h"
+#include "JSONLintProfile.h"
 /******************************************************************************
 * Defines
 ******************************************************************************/
 #define CHAR_HORIZONTAL_TAB		0x09
-#define CHAR_CARRIAGE_RETURN		0x0A
-#define CHAR_LINEFEED			0x0D
+#define CHAR_LINEFEED			0x0A
+#define CHAR_CARRIAGE_RETURN		0x0D
 #define CHAR_SPACE			0x20
 
-#define STRING_OBJECT_START		"{"
-#define STRING_ARRAY_START		"["
-#define STRING_STRING_START		"\""
-#define STRING_OBJECT_STOP		"}"
-#define STRING_ARRAY_STOP		"]"
-#define STRING_STRING_STOP		"\""
-#define STRING_COLON			":"
-#define STRING_COMMA			","
-#define STRING_BACKSLASH		"\\"
-#define STRING_SIGN_POS			"+"
-#define STRING_SIGN_NEG			"-"
-#define STRING_DECIMAL			"."
-#define STRING_0			"0"
+#define CHAR_OBJECT_START		'{'
+#define CHAR_ARRAY_START		'['
+#define CHAR_STRING_START		'"'
+#define CHAR_OBJECT_STOP		'}'
+#define CHAR_ARRAY_STOP			']'
+#define CHAR_STRING_STOP		'"'
+#define CHAR_COLON			':'
+#define CHAR_COMMA			','
+#define CHAR_BACKSLASH			'\\'
+#define CHAR_SIGN_POS			'+'
+#define CHAR_SIGN_NEG			'-'
+#define CHAR_DECIMAL			'.'
+#define CHAR_0				'0'
+#define CHAR_UNICODE			'u'
+#define CHAR_ASCII_END			0x80	//first byte that is not ASCII
+#define CHAR_POINTER_SEPARATOR	'/'		//starts each reference token of a JSON pointer
+#define CHAR_POINTER_ESCAPE		'~'		//~0 is ~ and ~1 is / in a reference token
+#define CHAR_COMMENT			'/'		//starts a comment in the relaxed dialect
+#define CHAR_COMMENT_BLOCK		'*'		//after a slash, starts a /* */ comment
 
 #define STRING_FALSE			"false"
 #define STRING_TRUE			"true"
 #define STRING_NULL			"null"
 
-#define STRING_ESCAPE_CHARS		"\"\\/bfnrtu"
-#define STRING_HEX_CHARS		"0123456789abcdefABCDEF"
-#define STRING_EXPONENT_DIGITS	"eE"
-#define STRING_DIGIT_1_9		"123456789"
-#define STRING_DIGIT_0_9		"0123456789"
+#define CLASS_DIGIT			0x01	//0-9
+#define CLASS_HEX			0x02	//0-9, a-f, A-F
+#define CLASS_ESCAPE			0x04	//character allowed after a backslash
+#define CLASS_EXPONENT			0x08	//e, E
+
+//counters of JSONLintProfile.h, the hooks are empty unless JSON_LINT_PROFILE
+//is defined
+#if defined(JSON_LINT_PROFILE)
+#define PROFILE_START(text)				uint8_t *profile_start = (text)
+#define PROFILE_CALL(function, text)	ProfileCall((function), (size_t)((text) - profile_start))
+#define PROFILE_LENGTH(function, length)	ProfileLength((function), (length))
+#define PROFILE_CLOCK(start)			uint64_t start = ProfileClock()
+#define PROFILE_TEXT(ctx, start)		ProfileText((ctx)->stats.max_depth, (start))
+#else
+#define PROFILE_START(text)
+#define PROFILE_CALL(function, text)
+#define PROFILE_LENGTH(function, length)
+#define PROFILE_CLOCK(start)
+#define PROFILE_TEXT(ctx, start)
+#endif
+
+//keeps a path that is only taken for an option out of the lint loops
+#if defined(_MSC_VER)
+#define NOINLINE				__declspec(noinline)
+#else
+#define NOINLINE				__attribute__((noinline))
+#endif
 
 /******************************************************************************
 * Type Definitions
@@ -82,17 +111,227 @@ typedef enum {
 	RESULT_JSON_SUCCESS,
 	RESULT_JSON_INVALID,
 	RESULT_JSON_NOT_FOUND,
+	RESULT_JSON_INCOMPLETE,
 } json_result_t;
 
+typedef enum {
+	STATE_VALUE,				//a value is next
+	STATE_OBJECT_FIRST,			//a key or the end of the object is next
+	STATE_OBJECT_KEY,			//a key is next
+	STATE_OBJECT_COLON,			//the colon after a key is next
+	STATE_OBJECT_SEPARATOR,		//a comma or the end of the object is next
+	STATE_ARRAY_FIRST,			//a value or the end of the array is next
+	STATE_ARRAY_SEPARATOR,		//a comma or the end of the array is next
+	STATE_DONE,					//the value of the text has been linted
+} json_state_t;
+
+typedef enum {
+	TOKEN_NONE,					//not inside a string, number or literal name
+	TOKEN_STRING_TEXT,			//inside the text of a string
+	TOKEN_STRING_ESCAPE,		//after a backslash
+	TOKEN_STRING_UNICODE,		//inside the 4 hex digits of a \u escape
+	TOKEN_STRING_UTF8,			//inside text that is not ASCII
+	TOKEN_NUMBER_START,			//at the first byte of a number
+	TOKEN_NUMBER_SIGN,			//the integer part is next
+	TOKEN_NUMBER_INTEGER,		//inside the digits of the integer part
+	TOKEN_NUMBER_INTEGER_END,	//after the integer part
+	TOKEN_NUMBER_DECIMAL,		//after the decimal point
+	TOKEN_NUMBER_FRACTION,		//inside the digits of the fraction
+	TOKEN_NUMBER_EXPONENT,		//after the e of the exponent
+	TOKEN_NUMBER_EXPONENT_SIGN,	//the digits of the exponent are next
+	TOKEN_NUMBER_EXPONENT_DIGITS,	//inside the digits of the exponent
+	TOKEN_LITERAL_FALSE,		//inside false
+	TOKEN_LITERAL_TRUE,			//inside true
+	TOKEN_LITERAL_NULL,			//inside null
+} json_token_t;
+
+typedef enum {
+	VALUE_INVALID,				//the byte does not start a value
+	VALUE_OBJECT,				//open curly bracket
+	VALUE_ARRAY,				//open square bracket
+	VALUE_STRING,				//quote
+	VALUE_NUMBER,				//minus sign or digit
+	VALUE_FALSE,				//f, then the literal names in the order of
+	VALUE_TRUE,					//TOKEN_LITERAL_FALSE, TRUE and NULL
+	VALUE_NULL,
+} json_value_t;
+
+typedef enum {
+	COMMENT_NONE,				//not inside a comment
+	COMMENT_SLASH,				//after the slash that starts a comment
+	COMMENT_LINE,				//inside a // comment
+	COMMENT_BLOCK,				//inside a /* */ comment
+	COMMENT_BLOCK_STAR,			//after a * inside a /* */ comment
+} json_comment_t;
+
+#define TOKEN_STRING_LAST		TOKEN_STRING_UTF8
+#define TOKEN_NUMBER_LAST		TOKEN_NUMBER_EXPONENT_DIGITS
+
+#define TAPE_NONE				0xFF	//the byte does not start a value
+
+#define KEY_TABLE_SLOTS			8		//slots of a new key table, a power of 2
+#define KEY_HASH_BASIS			2166136261u	//FNV-1a
+#define KEY_HASH_PRIME			16777619u
+
+#define NUMBER_DIGITS_MAX		19		//digits that always fit in the significand
+#define NUMBER_DIGITS_MIN_19	1000000000000000000ULL	//smallest 19 digit number
+#define NUMBER_EXPONENT_CAP		100000000u	//exponent digits past this are not added
+#define NUMBER_EXACT_MAX		((uint64_t)1 << 53)	//largest odd significand of a double
+#define NUMBER_EXACT_POWER_MAX	22		//largest power of ten of an exact double
+#define NUMBER_EXACT_DIVIDE_MAX	27		//largest power of five below 2^64
+#define NUMBER_DECIMAL_MAX		308		//power of ten of the largest double
+#define NUMBER_DECIMAL_MIN		(-324)	//power of ten of the smallest double
+#define NUMBER_ROUND_UP_19		1797693134862315807ULL	//first 19 digits of the
+										//smallest number that rounds to infinity
+#define NUMBER_ROUND_DOWN_19	2470328229206232720ULL	//first 19 digits of half
+										//the smallest double, which rounds to 0
+
+typedef enum {
+	POINTER_VALUE,				//the next value is named by the pointer up to
+								//the reference token
+	POINTER_SEARCH,				//inside the container the token is looked up in
+	POINTER_TARGET,				//inside the value named by the whole pointer
+} json_pointer_state_t;
+
+typedef struct {
+	size_t parent;				//offset of the table of the enclosing object
+	size_t keys_mark;			//keys_used of the arena when the object opened
+	uint32_t mask;				//slots - 1
+	uint32_t count;				//keys in the table
+} key_table_t;					//followed by mask + 1 slots
+
+typedef struct {
+	size_t offset;				//offset of the key in the keys of the arena
+	size_t length;				//bytes of the decoded key
+	uint32_t hash;				//hash of the key, 0 for an empty slot
+} key_slot_t;
+
+/******************************************************************************
+* Macros
+******************************************************************************/
+#define TOKEN_LENGTH(token)		(sizeof(token) - 1)
+#define IS_CLASS(index, end, class)	((index) < (end) && (char_class[*(index)] & (class)))
+#define IS_CHAR(index, end, c)		((index) < (end) && *(index) == (c))
+#define STACK_BIT(depth)		((uint64_t)1 << ((depth) % 64))
+#define TEXT_OFFSET(ctx, index)	((ctx)->offset + (size_t)((index) - (ctx)->chunk))
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+uint8_t *ptr_invalid_json;		//pointer to invalid json, set by LintJSON() and
+								//LintJSONN()
+
+//classification of every byte value, one lookup replaces the strchr() of a set
+static const uint8_t char_class[256] = {
+	['0'] = CLASS_DIGIT | CLASS_HEX, ['1'] = CLASS_DIGIT | CLASS_HEX,
+	['2'] = CLASS_DIGIT | CLASS_HEX, ['3'] = CLASS_DIGIT | CLASS_HEX,
+	['4'] = CLASS_DIGIT | CLASS_HEX, ['5'] = CLASS_DIGIT | CLASS_HEX,
+	['6'] = CLASS_DIGIT | CLASS_HEX, ['7'] = CLASS_DIGIT | CLASS_HEX,
+	['8'] = CLASS_DIGIT | CLASS_HEX, ['9'] = CLASS_DIGIT | CLASS_HEX,
+	['a'] = CLASS_HEX, ['b'] = CLASS_HEX | CLASS_ESCAPE, ['c'] = CLASS_HEX,
+	['d'] = CLASS_HEX, ['e'] = CLASS_HEX | CLASS_EXPONENT,
+	['f'] = CLASS_HEX | CLASS_ESCAPE,
+	['A'] = CLASS_HEX, ['B'] = CLASS_HEX, ['C'] = CLASS_HEX,
+	['D'] = CLASS_HEX, ['E'] = CLASS_HEX | CLASS_EXPONENT, ['F'] = CLASS_HEX,
+	['n'] = CLASS_ESCAPE, ['r'] = CLASS_ESCAPE, ['t'] = CLASS_ESCAPE,
+	['u'] = CLASS_ESCAPE, ['/'] = CLASS_ESCAPE,
+	['"'] = CLASS_ESCAPE, ['\\'] = CLASS_ESCAPE,
+};
+
+//json_value_t of every byte value, so a value is dispatched on one lookup
+static const uint8_t value_start[256] = {
+	['{'] = VALUE_OBJECT, ['['] = VALUE_ARRAY, ['"'] = VALUE_STRING,
+	['-'] = VALUE_NUMBER, ['0'] = VALUE_NUMBER, ['1'] = VALUE_NUMBER,
+	['2'] = VALUE_NUMBER, ['3'] = VALUE_NUMBER, ['4'] = VALUE_NUMBER,
+	['5'] = VALUE_NUMBER, ['6'] = VALUE_NUMBER, ['7'] = VALUE_NUMBER,
+	['8'] = VALUE_NUMBER, ['9'] = VALUE_NUMBER,
+	['f'] = VALUE_FALSE, ['t'] = VALUE_TRUE, ['n'] = VALUE_NULL,
+};
+
+//json_lint_tape_type_t of each json_value_t
+static const uint8_t value_tape_types[] = { TAPE_NONE, TAPE_JSON_LINT_OBJECT_BEGIN,
+	TAPE_JSON_LINT_ARRAY_BEGIN, TAPE_JSON_LINT_STRING, TAPE_JSON_LINT_NUMBER,
+	TAPE_JSON_LINT_FALSE, TAPE_JSON_LINT_TRUE, TAPE_JSON_LINT_NULL };
+
+//literal name tokens in the order of TOKEN_LITERAL_FALSE, TRUE and NULL
+static const char *const literal_names[] = { STRING_FALSE, STRING_TRUE, STRING_NULL };
+static const uint8_t literal_lengths[] = { TOKEN_LENGTH(STRING_FALSE),
+	TOKEN_LENGTH(STRING_TRUE), TOKEN_LENGTH(STRING_NULL) };
+
+//descriptions of the errors, indexed by json_lint_error_t
+static const char *const error_strings[] = {
+	[ERROR_JSON_LINT_NONE] = "no error",
+	[ERROR_JSON_LINT_EMPTY] = "no JSON text",
+	[ERROR_JSON_LINT_UNEXPECTED_END] = "unexpected end of text",
+	[ERROR_JSON_LINT_INVALID_VALUE] = "expected a value",
+	[ERROR_JSON_LINT_EXPECTED_KEY] = "expected a string key",
+	[ERROR_JSON_LINT_EXPECTED_COLON] = "expected ':' after key",
+	[ERROR_JSON_LINT_EXPECTED_SEPARATOR] = "expected ',' or close bracket",
+	[ERROR_JSON_LINT_INVALID_ESCAPE] = "invalid escape in string",
+	[ERROR_JSON_LINT_CONTROL_CHARACTER] = "unescaped control character in string",
+	[ERROR_JSON_LINT_INVALID_NUMBER] = "invalid number",
+	[ERROR_JSON_LINT_TRAILING_TEXT] = "text after the JSON value",
+	[ERROR_JSON_LINT_TOO_DEEP] = "nesting too deep",
+	[ERROR_JSON_LINT_NO_MEMORY] = "out of memory",
+	[ERROR_JSON_LINT_INVALID_UTF8] = "invalid UTF-8 in string",
+	[ERROR_JSON_LINT_TAPE_FULL] = "tape is full",
+	[ERROR_JSON_LINT_DUPLICATE_KEY] = "duplicate key",
+	[ERROR_JSON_LINT_TOO_LARGE] = "text too large",
+	[ERROR_JSON_LINT_STRING_TOO_LONG] = "string too long",
+	[ERROR_JSON_LINT_NUMBER_TOO_LONG] = "number too long",
+	[ERROR_JSON_LINT_TOO_MANY_MEMBERS] = "too many members",
+	[ERROR_JSON_LINT_OUTPUT_FULL] = "output buffer is full",
+	[ERROR_JSON_LINT_INVALID_COMMENT] = "expected / or * after / to start a comment",
+};
+
 /******************************************************************************
 * Function Prototypes
 ******************************************************************************/
-void ProcessWhitespace(uint8_t **index);
-json_result_t ProcessValue(uint8_t **index);
-json_result_t ProcessObject(uint8_t **index);
-json_result_t ProcessArray(uint8_t **index);
-json_result_t ProcessString(uint8_t **index);
-json_result_t ProcessNumber(uint8_t **index);
+json_result_t ProcessText(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessTextStrict(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessWhitespaceStrict(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessObjectStrict(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessArrayStrict(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessTextRelaxed(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessWhitespaceRelaxed(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessObjectRelaxed(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessArrayRelaxed(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t SkipComment(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+NOINLINE json_result_t ProcessRecover(json_lint_context_t *ctx, uint8_t *end);
+uint8_t *ResyncText(json_lint_context_t *ctx, uint8_t *end, uint8_t *restart);
+uint8_t *ResyncString(uint8_t *text, uint8_t *end);
+json_result_t ProcessValue(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessString(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessNumber(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t ProcessLiteral(json_lint_context_t *ctx, uint8_t **index, uint8_t *end);
+json_result_t PushContainer(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	bool object);
+void NumberDigits(json_lint_number_t *number, uint8_t *digits, uint8_t *end, bool fraction);
+void NumberExponent(json_lint_number_t *number, uint8_t *digits, uint8_t *end);
+uint8_t NumberClass(json_lint_number_t *number);
+void EndValue(json_lint_context_t *ctx);
+json_result_t TapeValue(json_lint_context_t *ctx, uint8_t *index, uint8_t *end);
+json_result_t TapeClose(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	json_lint_tape_type_t type);
+void TapeEnd(json_lint_context_t *ctx, uint8_t *index);
+void PointerValue(json_lint_context_t *ctx, uint8_t *index);
+void PointerKey(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end);
+void PointerEnd(json_lint_context_t *ctx, uint8_t *index);
+bool PointerIndex(const uint8_t *token, const uint8_t *token_end, size_t *index);
+bool MatchKey(uint8_t *key, uint8_t *key_end, const uint8_t *token, const uint8_t *token_end);
+uint32_t DecodeEscape(uint8_t **key, uint8_t *key_end, uint8_t *bytes);
+uint32_t HexValue(uint8_t *digits);
+json_result_t KeysOpen(json_lint_context_t *ctx, uint8_t *index, uint8_t *end);
+void KeysClose(json_lint_context_t *ctx);
+json_result_t KeysCut(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end, uint8_t *end);
+json_result_t KeysAdd(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end, uint8_t *end);
+bool KeysInsert(json_lint_arena_t *arena, size_t length, uint32_t hash);
+bool KeysGrow(json_lint_arena_t *arena);
+bool ArenaReserve(uint8_t **memory, size_t *size, size_t needed);
+NOINLINE void MinifyCopy(json_lint_context_t *ctx, uint8_t *index);
+bool MatchLiteral(uint8_t *index, uint8_t *end, uint8_t literal);
+json_result_t SetInvalid(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	json_lint_error_t error);
 
 /******************************************************************************
 * Functions
@@ -101,9 +340,8 @@ json_result_t ProcessNumber(uint8_t **index);
 * Function Name:  LintJSON
 *
 * Description:
-* Lint the JSON text as a recursive tree.  The tree starts with a JSON 
-* element which is a value with whitespace on either side.  If the JSON text 
-* is empty, the invalid result is returned and pointer to json error is set.
+* Lint the null terminated JSON text.  The length of the text is found and the
+* linting is done by LintJSONN().
 * 
 * Parameters:
 * ptr_text		uint8_t *		pointer to starting text to lint
@@ -116,37 +354,127 @@ json_result_t ProcessNumber(uint8_t **index);
 * 
 ******************************************************************************/
 json_lint_result_t LintJSON(uint8_t * ptr_text, bool disp_messages) {
-	json_result_t internal_result = RESULT_JSON_SUCCESS;
-	json_lint_result_t result = RESULT_JSON_LINT_SUCCESS;
-	uint8_t *ptr_text_start = ptr_text;
+	return LintJSONN(ptr_text, strlen((char *)ptr_text), disp_messages);
+}
 
-	ptr_invalid_json = NULL;
+/******************************************************************************
+* Function Name:  LintJSONN
+*
+* Description:
+* Lint the JSON text of the given length with a context local to the call and
+* set ptr_invalid_json from it.  The text does not need to be null terminated,
+* no byte at or after ptr_text + length is read.
+* 
+* Parameters:
+* ptr_text		uint8_t *		pointer to starting text to lint
+* length		size_t			number of bytes of text to lint
+* disp_message	bool			1=display the printf messages
+* 
+* Return Value: 
+* json_lint_result_t		result of parsing to calling application
+*
+* Notes:
+* ptr_invalid_json is shared by every caller, use LintJSONContext() to lint
+* from more than one thread.
+* 
+******************************************************************************/
+json_lint_result_t LintJSONN(uint8_t *ptr_text, size_t length, bool disp_messages) {
+	json_lint_context_t ctx;
+	json_lint_result_t result = RESULT_JSON_LINT_SUCCESS;
 
+	LintJSONInit(&ctx);
 	if (disp_messages)
 		printf("Starting JSON parsing...");
-	if (*ptr_text != NULL) {	//check if string exists
-		ProcessWhitespace(&ptr_text);
-		internal_result = ProcessValue(&ptr_text);
-		if (internal_result == RESULT_JSON_SUCCESS) {
-			ProcessWhitespace(&ptr_text);
-			//check for the end of string is the actual end and no extra text is there
-			if (strlen(ptr_text_start) != (ptr_text - ptr_text_start)) {
-				internal_result = RESULT_JSON_INVALID;
-				ptr_invalid_json = ptr_text;
-			} else {
-				if (disp_messages)
-					printf("Finished.\r\n");
-			}
+	result = LintJSONContext(&ctx, ptr_text, length);
+	ptr_invalid_json = ctx.ptr_invalid_json;
+	if (disp_messages) {
+		if (result == RESULT_JSON_LINT_SUCCESS) {
+			printf("Finished.\r\n");
+		} else if (ctx.error == ERROR_JSON_LINT_EMPTY) {
+			printf("No JSON to parse.\r\n");
 		} else {
-			if (disp_messages)
-				printf("\r\n");
+			printf("\r\n");
 		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONInit
+*
+* Description:
+* Set the options of the context to their defaults.  The options are kept by
+* LintJSONContext(), so the context only needs to be initialized once.
+* 
+* Parameters:
+* ctx			json_lint_context_t *	context to initialize
+* 
+* Return Value:	None.
+*
+* Notes:	None.
+* 
+******************************************************************************/
+void LintJSONInit(json_lint_context_t *ctx) {
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->max_depth = JSON_LINT_DEPTH_MAX;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONContext
+*
+* Description:
+* Lint the JSON text.  The text is a JSON element which is a value with 
+* whitespace on either side.  If the JSON text is empty, the invalid result is
+* returned and pointer to json error is set.  All state of the lint is kept in
+* the context, so any number of threads can lint at the same time with a
+* context each.
+* 
+* Parameters:
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* ptr_text		uint8_t *		pointer to starting text to lint
+* length		size_t			number of bytes of text to lint
+* 
+* Return Value: 
+* json_lint_result_t		result of parsing to calling application
+*
+* Notes:
+* If the result is RESULT_JSON_LINT_INVALID, ctx->ptr_invalid_json points to
+* the error and ctx->error holds the reason.  If the text ended early, 
+* ctx->ptr_invalid_json is ptr_text + length.  Nesting deeper than 
+* ctx->max_depth is reported as ERROR_JSON_LINT_TOO_DEEP.  A text longer than
+* ctx->max_length is reported as ERROR_JSON_LINT_TOO_LARGE at the first byte
+* over the limit without being linted.  If ctx->minify is set, the text
+* without its whitespace is written to it, ctx->minify_length bytes.  If
+* ctx->errors is set, the lint goes on after each error, see ProcessRecover().
+* 
+******************************************************************************/
+json_lint_result_t LintJSONContext(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length) {
+	json_result_t internal_result = RESULT_JSON_SUCCESS;
+	json_lint_result_t result = RESULT_JSON_LINT_SUCCESS;
+	uint8_t *end = ptr_text + length;
+	PROFILE_CLOCK(profile_clock);
+
+	LintJSONBegin(ctx);
+	ctx->final = true;
+	ctx->chunk = ptr_text;
+	ctx->minify_span = ptr_text;
+
+	if (ctx->max_length != 0 && length > ctx->max_length) {
+		internal_result = SetInvalid(ctx, ptr_text + ctx->max_length, end, ERROR_JSON_LINT_TOO_LARGE);
+	} else if (ctx->minify != NULL && length > ctx->minify_size) {
+		internal_result = SetInvalid(ctx, ptr_text + ctx->minify_size, end, ERROR_JSON_LINT_OUTPUT_FULL);
+	} else if (length > 0) {	//check if string exists
+		internal_result = ProcessText(ctx, &ptr_text, end);
 	}else {
-		if (disp_messages)
-			printf("No JSON to parse.\r\n");
-		internal_result = RESULT_JSON_INVALID;
-		ptr_invalid_json = ptr_text;
+		internal_result = SetInvalid(ctx, ptr_text, end, ERROR_JSON_LINT_EMPTY);
+	}
+	if (internal_result == RESULT_JSON_SUCCESS && ctx->minify != NULL) {
+		MinifyCopy(ctx, end);
+	} else if (internal_result != RESULT_JSON_SUCCESS && ctx->errors != NULL) {
+		internal_result = ProcessRecover(ctx, end);
 	}
+	PROFILE_TEXT(ctx, profile_clock);
 
 	//convert internal result typedef to the external one
 	if (internal_result == RESULT_JSON_SUCCESS) {
@@ -159,333 +487,2169 @@ json_lint_result_t LintJSON(uint8_t * ptr_text, bool disp_messages) {
 }
 
 /******************************************************************************
-* Function Name:  ProcessWhitespace
+* Function Name:  LintJSONBegin
 *
 * Description:
-* Increment the pointer as valid whitespace is found (space, line feed, 
-* carriage return, tab).
-*
+* Start linting a JSON text that is given in chunks with LintJSONFeed().  The
+* options of the context are kept.
+* 
 * Parameters:
-* index		uint8_t **		pointer to starting pointer of text to lint
-*
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* 
 * Return Value:	None.
 *
 * Notes:	None.
-*
+* 
 ******************************************************************************/
-void ProcessWhitespace(uint8_t **index) {
-	bool whitespace_end = false;
-
-	while (!whitespace_end) {
-		switch (**index) {
-		case CHAR_SPACE:
-		case CHAR_LINEFEED:
-		case CHAR_CARRIAGE_RETURN:
-		case CHAR_HORIZONTAL_TAB:
-			(*index)++;
-			break;
-		default:
-			whitespace_end = true;
-			break;
-		}
+void LintJSONBegin(json_lint_context_t *ctx) {
+	ctx->ptr_invalid_json = NULL;
+	ctx->offset_invalid_json = 0;
+	ctx->error = ERROR_JSON_LINT_NONE;
+	ctx->depth = 0;
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	ctx->state = STATE_VALUE;
+	ctx->token = TOKEN_NONE;
+	ctx->token_count = 0;
+	ctx->comment = COMMENT_NONE;
+	memset(&ctx->number, 0, sizeof(ctx->number));
+	ctx->final = false;
+	ctx->offset = 0;
+	ctx->chunk = NULL;
+	ctx->tape_count = 0;
+	ctx->tape_open = 0;
+	ctx->minify_length = 0;
+	ctx->minify_span = NULL;
+	ctx->error_count = 0;
+	if (ctx->key_arena != NULL) {
+		ctx->key_arena->tables_used = 0;
+		ctx->key_arena->keys_used = 0;
+		ctx->key_arena->cut_length = 0;
+		ctx->key_arena->cut = false;
+	}
+	if (ctx->max_depth > JSON_LINT_DEPTH_MAX) {
+		ctx->max_depth = JSON_LINT_DEPTH_MAX;
 	}
 }
 
 /******************************************************************************
-* Function Name:  ProcessValue
+* Function Name:  LintJSONBeginMember
 *
 * Description:
-* Check the 7 possible values.  Increment the pointer if it is one of the 3
-* literal name tokens (true, false, null).  If it is an object, string or 
-* array, call the processing function to continue processing the value.  If the
-* value encountered is none of the 7 possibilities, set as invalid JSON.
-*
+* Start linting a piece of a JSON text that begins just after a comma between
+* two members of an object or two values of an array.  The open objects and
+* arrays at the comma are given, the last one selects whether a key or a 
+* value is expected next.  The piece is then given with LintJSONFeed().
+* 
 * Parameters:
-* index		uint8_t **		pointer to a pointer of starting text to lint
-*
-* Return Value:
-* json_result_t		RESULT_JSON_SUCCESS - the value has been parsed
-*					RESULT_JSON_NOT_FOUND - there is no value
-*					RESULT_JSON_INVALID - the text does not follow JSON
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* offset		size_t					offset of the piece from the start of text
+* depth			uint32_t				number of open objects and arrays, 1 or more
+* stack			const uint64_t *		1 bit per open object or array, 1=object
+*										0=array, the first one in the low bit
+* 
+* Return Value:	None.
 *
 * Notes:
-* If the result of processing is invalid, the pointer ptr_invalid_json will be
-* set to the location of the error.
+* Used to lint the pieces of one text separately.  The context ends a piece in
+* the same state as a context that linted the whole text up to its end.
+* 
+******************************************************************************/
+void LintJSONBeginMember(json_lint_context_t *ctx, size_t offset, uint32_t depth, const uint64_t *stack) {
+	LintJSONBegin(ctx);
+	memcpy(ctx->stack, stack, sizeof(ctx->stack));
+	ctx->depth = depth;
+	ctx->offset = offset;
+	if (ctx->stack[(depth - 1) / 64] & STACK_BIT(depth - 1)) {
+		ctx->state = STATE_OBJECT_KEY;
+	} else {
+		ctx->state = STATE_VALUE;
+	}
+}
+
+/******************************************************************************
+* Function Name:  LintJSONAddStats
+*
+* Description:
+* Add the counts of one lint to a total.
+* 
+* Parameters:
+* total		json_lint_stats_t *			total to add to
+* stats		const json_lint_stats_t *	counts to add
+* 
+* Return Value:	None.
 *
+* Notes:
+* The deepest nesting of the total is the deeper of the two.
+* 
 ******************************************************************************/
-json_result_t ProcessValue(uint8_t **index) {
-	json_result_t result = RESULT_JSON_SUCCESS;
+void LintJSONAddStats(json_lint_stats_t *total, const json_lint_stats_t *stats) {
+	total->objects += stats->objects;
+	total->arrays += stats->arrays;
+	total->keys += stats->keys;
+	total->strings += stats->strings;
+	total->numbers += stats->numbers;
+	total->literals += stats->literals;
+	if (stats->max_depth > total->max_depth) {
+		total->max_depth = stats->max_depth;
+	}
+}
 
-	if ((result = ProcessObject(index)) != RESULT_JSON_NOT_FOUND ) {
+/******************************************************************************
+* Function Name:  LintJSONFeed
+*
+* Description:
+* Lint the next chunk of a JSON text started with LintJSONBegin().  A chunk may
+* end anywhere, including inside a string, escape, number or literal name, the
+* state of the parser is kept in the context until the next chunk.  The chunk
+* is not needed after the call returns.
+* 
+* Parameters:
+* ctx			json_lint_context_t *	context started with LintJSONBegin()
+* chunk			uint8_t *		pointer to the next bytes of text
+* length		size_t			number of bytes in the chunk
+* 
+* Return Value: 
+* json_lint_result_t	RESULT_JSON_LINT_INCOMPLETE - no error so far
+*						RESULT_JSON_LINT_INVALID - the text does not follow JSON
+*
+* Notes:
+* An error is reported in the chunk that has the invalid byte.  
+* ctx->ptr_invalid_json points into that chunk and ctx->offset_invalid_json is
+* the offset from the start of the text.  The chunk that takes the text past
+* ctx->max_length, or past ctx->minify_size when minifying, is not linted, the
+* error is at the first byte over the limit.  The minified text of the chunks
+* is written after each other to ctx->minify.
+* 
+******************************************************************************/
+json_lint_result_t LintJSONFeed(json_lint_context_t *ctx, uint8_t *chunk, size_t length) {
+	json_lint_result_t result = RESULT_JSON_LINT_INCOMPLETE;
 
-	}else if ((result = ProcessArray(index)) != RESULT_JSON_NOT_FOUND) {
+	if (ctx->error == ERROR_JSON_LINT_NONE) {
+		ctx->chunk = chunk;
+		ctx->minify_span = chunk;
+		if (ctx->max_length != 0 && length > ctx->max_length - ctx->offset) {
+			SetInvalid(ctx, chunk + (ctx->max_length - ctx->offset), chunk + length, ERROR_JSON_LINT_TOO_LARGE);
+			result = RESULT_JSON_LINT_INVALID;
+		} else if (ctx->minify != NULL && length > ctx->minify_size - ctx->offset) {
+			SetInvalid(ctx, chunk + (ctx->minify_size - ctx->offset), chunk + length, ERROR_JSON_LINT_OUTPUT_FULL);
+			result = RESULT_JSON_LINT_INVALID;
+		} else if (ProcessText(ctx, &chunk, chunk + length) == RESULT_JSON_INVALID) {
+			result = RESULT_JSON_LINT_INVALID;
+		} else if (ctx->minify != NULL) {
+			MinifyCopy(ctx, ctx->chunk + length);
+		}
+		ctx->offset += length;
+	} else {
+		result = RESULT_JSON_LINT_INVALID;
+	}
 
-	} else if ((result = ProcessString(index)) != RESULT_JSON_NOT_FOUND) {
+	return result;
+}
 
-	}else if ((result=ProcessNumber(index)) != RESULT_JSON_NOT_FOUND){
+/******************************************************************************
+* Function Name:  LintJSONFinish
+*
+* Description:
+* End the JSON text given with LintJSONFeed().  The text is valid if it holds
+* one complete value.
+* 
+* Parameters:
+* ctx			json_lint_context_t *	context started with LintJSONBegin()
+* 
+* Return Value: 
+* json_lint_result_t		result of parsing to calling application
+*
+* Notes:
+* If the text ends early, ctx->ptr_invalid_json is NULL as there is no chunk
+* to point to, and ctx->offset_invalid_json is the length of the text.
+* 
+******************************************************************************/
+json_lint_result_t LintJSONFinish(json_lint_context_t *ctx) {
+	json_result_t internal_result = RESULT_JSON_INVALID;
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
+	uint8_t *index = NULL;
 
-	}else if (strncmp(*index, STRING_FALSE, strlen(STRING_FALSE)) == 0) {
-		(*index) += strlen(STRING_FALSE);
-		result = RESULT_JSON_SUCCESS;
-	}else if (strncmp(*index, STRING_TRUE, strlen(STRING_TRUE)) == 0) {
-		(*index) += strlen(STRING_TRUE);
-		result = RESULT_JSON_SUCCESS;
-	}else if (strncmp(*index, STRING_NULL, strlen(STRING_NULL)) == 0) {
-		(*index) += strlen(STRING_NULL);
-		result = RESULT_JSON_SUCCESS;
-	}else{
-		result = RESULT_JSON_INVALID;
-		ptr_invalid_json = *index;
+	if (ctx->error == ERROR_JSON_LINT_NONE) {
+		ctx->final = true;
+		ctx->chunk = NULL;
+		if (ctx->offset > 0) {
+			internal_result = ProcessText(ctx, &index, NULL);
+		} else {
+			internal_result = SetInvalid(ctx, index, NULL, ERROR_JSON_LINT_EMPTY);
+		}
+	}
+	PROFILE_TEXT(ctx, 0);
+	if (internal_result == RESULT_JSON_SUCCESS) {
+		result = RESULT_JSON_LINT_SUCCESS;
 	}
 
 	return result;
 }
 
 /******************************************************************************
-* Function Name:  ProcessObject
+* Function Name:  LintJSONErrorString
 *
 * Description:
-* Search for the object open curly bracket token to start the object.  If found
-* then search for 0 or more string value pairs.
+* Give a short description of the reason a JSON text is invalid.
 * 
 * Parameters:
-* index		uint8_t **		pointer to a pointer of starting text to lint
+* error		json_lint_error_t		reason from the lint context
+* 
+* Return Value:
+* const char *		description, such as "expected ':' after key"
+*
+* Notes:	None.
+* 
+******************************************************************************/
+const char *LintJSONErrorString(json_lint_error_t error) {
+	const char *string = "unknown error";
+
+	if ((size_t)error < sizeof(error_strings) / sizeof(error_strings[0]) && error_strings[error] != NULL) {
+		string = error_strings[error];
+	}
+
+	return string;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONArenaFree
+*
+* Description:
+* Free the memory of an arena used to check for duplicate keys.  The arena
+* can be used again.
+*
+* Parameters:
+* arena		json_lint_arena_t *		arena to free
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintJSONArenaFree(json_lint_arena_t *arena) {
+	free(arena->tables);
+	free(arena->keys);
+	memset(arena, 0, sizeof(*arena));
+}
+
+/******************************************************************************
+* Function Name:  LintJSONPointer
+*
+* Description:
+* Lint the JSON text and find the value named by a JSON pointer (RFC 6901),
+* such as "/items/0/id".  The pointer is followed while the text is linted,
+* so no tree of the text is built.  Once the value is found, or the pointer
+* leaves the text, the rest of the text is only linted.
+*
+* Parameters:
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* ptr_text		uint8_t *		pointer to starting text to lint
+* length		size_t			number of bytes of text to lint
+* pointer		const char *	JSON pointer, "" for the whole text
+* value			uint8_t **		set to the first byte of the value found, or
+*								NULL if the text has no such value
+* value_length	size_t *		set to the bytes of the value found, or 0
 *
 * Return Value:
-* json_result_t		RESULT_JSON_SUCCESS - the object has been parsed
-*					RESULT_JSON_NOT_FOUND - there is no object
-*					RESULT_JSON_INVALID - the text does not follow JSON
+* json_lint_result_t		result of parsing to calling application
 *
 * Notes:
-* If the result of processing is invalid, the pointer ptr_invalid_json will be
-* set to the location of the error.
+* The value is only given when the whole text is valid.  Keys are compared
+* after their escapes are decoded, a pointer that does not start with / names
+* no value.  If an object has the key more than once the first is used.
 *
 ******************************************************************************/
-json_result_t ProcessObject(uint8_t **index) {
-	json_result_t result = RESULT_JSON_SUCCESS;
-	uint8_t *key_name;
-	uint8_t *key_position;
-	uint8_t key_size;
-
-	if (strncmp(*index, STRING_OBJECT_START, strlen(STRING_OBJECT_START)) == 0 ) {
-		(*index) += strlen(STRING_OBJECT_START);
-		ProcessWhitespace(index);
-		while (!strncmp(*index, STRING_OBJECT_STOP, strlen(STRING_OBJECT_STOP)) == 0 
-			&& result == RESULT_JSON_SUCCESS) {
-			if ((result = ProcessString(index)) == RESULT_JSON_SUCCESS) {
-				ProcessWhitespace(index);
-				if (strncmp(*index, STRING_COLON, strlen(STRING_COLON)) == 0) {
-					(*index) ++;
-					if ((result=ProcessValue(index)) == RESULT_JSON_SUCCESS) {
-						if (strncmp(*index, STRING_COMMA, strlen(STRING_COMMA)) == 0) {
-							(*index) ++;
-						}else if (strncmp(*index, STRING_OBJECT_STOP, strlen(STRING_OBJECT_STOP)) == 0) {
-
-						}else {
-							result = RESULT_JSON_INVALID;
-							ptr_invalid_json = *index;
-						}
-					}
-				}else {
-					result = RESULT_JSON_INVALID;
-					ptr_invalid_json = *index;
-				}
-			}else {
-				result = RESULT_JSON_INVALID;
-				ptr_invalid_json = *index;
-			}
-		}
-		(*index) += strlen(STRING_OBJECT_STOP);
+json_lint_result_t LintJSONPointer(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length,
+	const char *pointer, uint8_t **value, size_t *value_length) {
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
+	json_lint_pointer_t lookup;
+
+	memset(&lookup, 0, sizeof(lookup));
+	lookup.next = (const uint8_t *)pointer;
+	lookup.end = lookup.next + strlen(pointer);
+	lookup.state = POINTER_VALUE;
+	if (lookup.next == lookup.end || *lookup.next == CHAR_POINTER_SEPARATOR) {
+		ctx->pointer = &lookup;
+	}
+	result = LintJSONContext(ctx, ptr_text, length);
+	ctx->pointer = NULL;
+
+	if (result == RESULT_JSON_LINT_SUCCESS && lookup.length > 0) {
+		*value = ptr_text + lookup.offset;
+		*value_length = lookup.length;
 	} else {
-		result = RESULT_JSON_NOT_FOUND;
+		*value = NULL;
+		*value_length = 0;
 	}
 
 	return result;
 }
 
 /******************************************************************************
-* Function Name:  ProcessArray
+* Function Name:  LintJSONMinify
 *
 * Description:
-* Search for the object open square bracket token to start the array.  If 
-* found then search for zero or more values.
+* Lint the JSON text and write it without its whitespace in the same pass.
+* The text between runs of whitespace is copied in one piece each time
+* whitespace is skipped, so strings and numbers are not copied a byte at a
+* time.
 *
 * Parameters:
-* index		uint8_t **		pointer to a pointer of starting text to lint
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* ptr_text		uint8_t *		pointer to starting text to lint
+* length		size_t			number of bytes of text to lint
+* output		uint8_t *		buffer of at least length bytes for the
+*								minified text, may be ptr_text
+* output_length	size_t *		set to the bytes of the minified text, or 0
 *
 * Return Value:
-* json_result_t		RESULT_JSON_SUCCESS - the array has been parsed
-*					RESULT_JSON_NOT_FOUND - there is no array
-*					RESULT_JSON_INVALID - the text does not follow JSON
+* json_lint_result_t		result of parsing to calling application
 *
 * Notes:
-* If the result of processing is invalid, the pointer ptr_invalid_json will be
-* set to the location of the error.
+* The minified text is never longer than the text and is written behind the
+* byte being linted, so the text can be compacted in place by giving ptr_text
+* as the output.  In place, the bytes before an error are changed.
 *
 ******************************************************************************/
-json_result_t ProcessArray(uint8_t **index) {
-	json_result_t result = RESULT_JSON_SUCCESS;
-
-	if (strncmp(*index, STRING_ARRAY_START, strlen(STRING_ARRAY_START)) == 0) {
-		(*index) += strlen(STRING_ARRAY_START);
-		ProcessWhitespace(index);
-		while (!strncmp(*index, STRING_ARRAY_STOP, strlen(STRING_ARRAY_STOP)) == 0
-			&& result == RESULT_JSON_SUCCESS) {
-			if ((result = ProcessValue(index)) == RESULT_JSON_SUCCESS) {
-				ProcessWhitespace(index);
-				if (strncmp(*index, STRING_COMMA, strlen(STRING_COMMA)) == 0) {
-					(*index)++;
-					ProcessWhitespace(index);
-				} else if (strncmp(*index, STRING_ARRAY_STOP, strlen(STRING_ARRAY_STOP)) == 0) {
+json_lint_result_t LintJSONMinify(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length,
+	uint8_t *output, size_t *output_length) {
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
 
-				} else {
-					result = RESULT_JSON_INVALID;
-					ptr_invalid_json = *index;
-				}
-			}
-		}
-		if (result == RESULT_JSON_SUCCESS) {
-			(*index) += strlen(STRING_ARRAY_STOP);
-		}
-	} else {
-		result = RESULT_JSON_NOT_FOUND;
-	}
+	ctx->minify = output;
+	ctx->minify_size = length;
+	result = LintJSONContext(ctx, ptr_text, length);
+	*output_length = (result == RESULT_JSON_LINT_SUCCESS) ? ctx->minify_length : 0;
+	ctx->minify = NULL;
+	ctx->minify_size = 0;
 
 	return result;
 }
 
 /******************************************************************************
-* Function Name:  ProcessString
+* Function Name:  LintJSONLocate
 *
 * Description:
-* Search for the start of a string --> ".  If found then process, including
-* escape characters.
+* Find the line and column of an offset in a text, such as the offset of an
+* error.  The line feeds before the offset are counted by ScanLines().
+*
+* Parameters:
+* ptr_text		const uint8_t *		pointer to the start of the text
+* offset		size_t				offset from the start of text
+* location		json_lint_location_t *	line and column of the offset, set to
+*									0 before the first call for a text
+*
+* Return Value:	None.
+*
+* Notes:
+* Nothing is counted until this is called, so a lint that finds no error pays
+* nothing for lines.  When location holds an earlier offset of the same text,
+* counting goes on from there, so the errors of a text found in order cost one
+* pass over the text in all.
+*
+******************************************************************************/
+void LintJSONLocate(const uint8_t *ptr_text, size_t offset, json_lint_location_t *location) {
+	const uint8_t *line_start;
+
+	if (location->line == 0 || offset < location->offset) {
+		location->offset = 0;
+		location->line = 1;
+		location->line_offset = 0;
+	}
+	line_start = ptr_text + location->line_offset;
+	location->line += ScanLines(ptr_text + location->offset, ptr_text + offset, &line_start);
+	location->line_offset = (size_t)(line_start - ptr_text);
+	location->offset = offset;
+	location->column = offset - location->line_offset + 1;
+}
+
+/******************************************************************************
+* Function Name:  ProcessText
+*
+* Description:
+* Lint text until the end of the text or an error is found, with the
+* functions of the dialect of the context.
 *
 * Parameters:
+* ctx		json_lint_context_t *	lint context of the text
 * index		uint8_t **		pointer to a pointer of starting text to lint
+* end		uint8_t *		pointer to one past the last byte of text
 *
 * Return Value:
-* json_result_t		RESULT_JSON_SUCCESS - the string has been parsed
-*					RESULT_JSON_NOT_FOUND - there is no string
-*					RESULT_JSON_INVALID - the text does not follow JSON
+* json_result_t		result of ProcessTextStrict() or ProcessTextRelaxed()
 *
 * Notes:
-* If the result of processing is invalid, the pointer ptr_invalid_json will be
-* set to the location of the error.
+* The dialect is chosen once for each chunk rather than for each byte.
 *
 ******************************************************************************/
-json_result_t ProcessString(uint8_t **index) {
-	json_result_t result = RESULT_JSON_SUCCESS;
+json_result_t ProcessText(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
+	json_result_t result;
+	PROFILE_START(*index);
 
-	if (strncmp(*index, STRING_STRING_START, strlen(STRING_STRING_START)) == 0) {
-		(*index) += strlen(STRING_STRING_START);
-		while (!strncmp(*index, STRING_STRING_STOP, strlen(STRING_STRING_STOP)) == 0
-			&& result == RESULT_JSON_SUCCESS) {
-			if ((*index)[0] == '\\') {
-				(*index)++;
-				if (strchr(STRING_ESCAPE_CHARS, (*index)[0])) {
-					if (*(index)[0] == 'u') {
-						(*index)++;
-						if (strchr(STRING_HEX_CHARS, (*index)[0]) &&
-							strchr(STRING_HEX_CHARS, (*index)[1]) &&
-							strchr(STRING_HEX_CHARS, (*index)[2]) &&
-							strchr(STRING_HEX_CHARS, (*index)[3])) {
-							(*index) += 4;
-						} else {
-							result = RESULT_JSON_INVALID;
-							ptr_invalid_json = *index;
-						}
-					} else {
-						(*index)++;
-					}
-				} else {
-					result = RESULT_JSON_INVALID;
-					ptr_invalid_json = *index;
-				}
-			} else {
-				(*index)++;
-			}
-		}
-		if (result == RESULT_JSON_SUCCESS) {
-			(*index) += strlen(STRING_STRING_STOP);
-		}
+	if (ctx->dialect == DIALECT_JSON_LINT_RELAXED) {
+		result = ProcessTextRelaxed(ctx, index, end);
 	} else {
-		result = RESULT_JSON_NOT_FOUND;
+		result = ProcessTextStrict(ctx, index, end);
 	}
+	PROFILE_CALL(PROFILE_JSON_LINT_TEXT, *index);
 
 	return result;
 }
 
+//the functions of each dialect, ProcessTextStrict() and so on
+#define JSON_LINT_RELAXED		0
+#define DIALECT(name)			name##Strict
+#include "JSONLintDialect.inc"
+#undef JSON_LINT_RELAXED
+#undef DIALECT
+
+#define JSON_LINT_RELAXED		1
+#define DIALECT(name)			name##Relaxed
+#include "JSONLintDialect.inc"
+#undef JSON_LINT_RELAXED
+#undef DIALECT
+
 /******************************************************************************
-* Function Name:  ProcessNumber
+* Function Name:  SkipComment
 *
 * Description:
-* Process the number defined in the JSON specification.
-* 
+* Skip a comment of the relaxed dialect, or continue the comment that was cut
+* by the end of the last chunk.  A line comment ends after its line feed and
+* a block comment after the star and slash that close it.
+*
 * Parameters:
-* index		uint8_t **		pointer to a pointer of starting text to lint
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t **		pointer to the slash that starts the comment, or
+*							to the first byte of the chunk when inside one
+* end		uint8_t *		pointer to one past the last byte of text
 *
 * Return Value:
-* json_result_t		RESULT_JSON_SUCCESS - the number has been parsed
-*					RESULT_JSON_NOT_FOUND - there is no number
-*					RESULT_JSON_INVALID - the text does not follow JSON
+* json_result_t		RESULT_JSON_SUCCESS - the comment, or the part of it in
+*					the chunk, has been skipped
+*					RESULT_JSON_INVALID - the slash is not followed by / or *
 *
 * Notes:
-* If the result of processing is invalid, the pointer ptr_invalid_json will be
-* set to the location of the error.
-* 
+* The byte after a slash that does not start a comment is reported as
+* ERROR_JSON_LINT_INVALID_COMMENT, so the error is the same when the slash is
+* the last byte of a chunk.  ctx->comment holds where a comment was cut.
+*
 ******************************************************************************/
-json_result_t ProcessNumber(uint8_t **index) {
+json_result_t SkipComment(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
 	json_result_t result = RESULT_JSON_SUCCESS;
+	uint8_t *text = *index;
+	uint8_t *found;
+	PROFILE_START(text);
 
-	if (strncmp(*index, STRING_SIGN_NEG, strlen(STRING_SIGN_NEG)) == 0
-		|| strncmp(*index, STRING_0, strlen(STRING_0))==0
-		|| strchr(STRING_DIGIT_1_9, (*index)[0])) {
-		if(strncmp(*index, STRING_SIGN_NEG, strlen(STRING_SIGN_NEG)) == 0) {
-			(*index)++;
-			if (strchr(STRING_DIGIT_1_9, (*index)[0])) {
-				(*index++);
-				while (strchr(STRING_DIGIT_0_9, (*index)[0]) && strlen((*index))) {
-					(*index)++;
-				}
-			}else if(strncmp(*index, STRING_0, strlen(STRING_0)) == 0){
-				(*index)++;
+	if (ctx->comment == COMMENT_NONE) {
+		text++;
+		ctx->comment = COMMENT_SLASH;
+	}
+	if (ctx->comment == COMMENT_SLASH && text < end) {
+		if (*text == CHAR_COMMENT) {
+			text++;
+			ctx->comment = COMMENT_LINE;
+		} else if (*text == CHAR_COMMENT_BLOCK) {
+			text++;
+			ctx->comment = COMMENT_BLOCK;
+		} else {
+			result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_COMMENT);
+		}
+	}
+	if (ctx->comment == COMMENT_LINE && text < end) {
+		found = memchr(text, CHAR_LINEFEED, (size_t)(end - text));
+		if (found != NULL) {
+			text = found + 1;
+			ctx->comment = COMMENT_NONE;
+		} else {
+			text = end;
+		}
+	}
+	while (ctx->comment >= COMMENT_BLOCK && text < end) {
+		if (ctx->comment == COMMENT_BLOCK_STAR && *text == CHAR_COMMENT) {
+			ctx->comment = COMMENT_NONE;
+		} else if (*text == CHAR_COMMENT_BLOCK) {
+			ctx->comment = COMMENT_BLOCK_STAR;
+		} else {
+			found = memchr(text, CHAR_COMMENT_BLOCK, (size_t)(end - text));
+			ctx->comment = COMMENT_BLOCK;
+			text = (found != NULL) ? found - 1 : end - 1;
+		}
+		text++;
+	}
+	*index = text;
+	PROFILE_CALL(PROFILE_JSON_LINT_COMMENT, text);
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  ProcessRecover
+*
+* Description:
+* Record the error found by the lint in ctx->errors and go on linting after
+* it, until the end of the text or ctx->errors_size errors.  After each error
+* the text is skipped up to the next comma or close bracket of an open object
+* or array by ResyncText(), and linted again from there.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text, holding an error
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_INVALID - the text has at least one error
+*
+* Notes:
+* ctx->ptr_invalid_json, ctx->offset_invalid_json and ctx->error are left as
+* the first error.  The lint only goes on when there is no tape, key arena,
+* pointer or minify output, as those can not be kept right across a skip, and
+* an error outside of every object and array, such as trailing text, ends it.
+*
+******************************************************************************/
+NOINLINE json_result_t ProcessRecover(json_lint_context_t *ctx, uint8_t *end) {
+	json_result_t result = RESULT_JSON_INVALID;
+	uint8_t *ptr_first = ctx->ptr_invalid_json;	//the first error
+	size_t offset_first = ctx->offset_invalid_json;
+	json_lint_error_t error_first = ctx->error;
+	bool recover = (ctx->tape == NULL && ctx->key_arena == NULL && ctx->pointer == NULL &&
+		ctx->minify == NULL);
+	uint8_t *index = NULL;		//where the lint goes on, NULL to stop
+	uint8_t *restart = NULL;	//where the lint last went on
+
+	do {
+		if (ctx->error_count < ctx->errors_size) {
+			ctx->errors[ctx->error_count].offset_invalid_json = ctx->offset_invalid_json;
+			ctx->errors[ctx->error_count].error = ctx->error;
+			ctx->error_count++;
+		}
+		index = NULL;
+		if (recover && ctx->error_count < ctx->errors_size) {
+			index = ResyncText(ctx, end, restart);
+		}
+		if (index != NULL) {
+			restart = index;
+			ctx->error = ERROR_JSON_LINT_NONE;
+			result = ProcessText(ctx, &index, end);
+		}
+	} while (index != NULL && result != RESULT_JSON_SUCCESS);
+	ctx->ptr_invalid_json = ptr_first;
+	ctx->offset_invalid_json = offset_first;
+	ctx->error = error_first;
+
+	return RESULT_JSON_INVALID;
+}
+
+/******************************************************************************
+* Function Name:  ResyncText
+*
+* Description:
+* Find where to go on linting after an error: the next comma or close bracket
+* that is not inside a string or inside a container opened after the error.
+* The rest of a string the error is in is skipped first.  The open objects and
+* arrays are closed up to the one the bracket closes, and the context is set
+* to expect the comma or bracket next.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text, holding an error
+* end		uint8_t *		pointer to one past the last byte of text
+* restart	uint8_t *		where the lint last went on, NULL for none
+*
+* Return Value:
+* uint8_t *		the comma or close bracket to lint from, NULL if there is
+*				none or the error is outside of every object and array
+*
+* Notes:
+* An error at restart is the comma or bracket itself, so it is skipped to be
+* sure each error moves the lint forward.  In the relaxed dialect, commas and
+* brackets in comments are skipped.
+*
+******************************************************************************/
+uint8_t *ResyncText(json_lint_context_t *ctx, uint8_t *end, uint8_t *restart) {
+	uint8_t *text = ctx->ptr_invalid_json;
+	uint8_t *resume = NULL;
+	uint32_t nesting = 0;		//containers opened in the text skipped
+	bool object;
+
+	if (text == restart) {
+		text++;
+	}
+	if (ctx->token != TOKEN_NONE && ctx->token <= TOKEN_STRING_LAST &&
+		ctx->error != ERROR_JSON_LINT_CONTROL_CHARACTER) {
+		text = ResyncString(text, end);
+	}
+	ctx->token = TOKEN_NONE;
+	ctx->token_count = 0;
+	ctx->comment = COMMENT_NONE;
+	if (ctx->depth == 0) {
+		text = end;
+	}
+	while (text < end && resume == NULL) {
+		if (*text == CHAR_STRING_START) {
+			text = ResyncString(text + 1, end);
+		} else if (*text == CHAR_OBJECT_START || *text == CHAR_ARRAY_START) {
+			nesting++;
+			text++;
+		} else if (*text == CHAR_OBJECT_STOP || *text == CHAR_ARRAY_STOP || *text == CHAR_COMMA) {
+			if (nesting == 0) {
+				resume = text;
 			} else {
-				result = RESULT_JSON_INVALID;
-				ptr_invalid_json = *index;
+				nesting -= (*text != CHAR_COMMA);
+				text++;
 			}
-		} else if (strchr(STRING_DIGIT_1_9, (*index)[0])) {
-			(*index)++;
-			while (strchr(STRING_DIGIT_0_9, (*index)[0]) && strlen((*index))) {
+		} else if (ctx->dialect == DIALECT_JSON_LINT_RELAXED && *text == CHAR_COMMENT &&
+			end - text >= 2 && (text[1] == CHAR_COMMENT || text[1] == CHAR_COMMENT_BLOCK)) {
+			SkipComment(ctx, &text, end);
+			ctx->comment = COMMENT_NONE;
+		} else {
+			text++;
+		}
+	}
+	if (resume != NULL && *resume != CHAR_COMMA) {
+		//close the containers the bracket does not match
+		object = (*resume == CHAR_OBJECT_STOP);
+		while (ctx->depth > 0 && ((ctx->stack[(ctx->depth - 1) / 64] & STACK_BIT(ctx->depth - 1)) != 0) != object) {
+			ctx->depth--;
+		}
+		if (ctx->depth == 0) {
+			resume = NULL;
+		}
+	}
+	if (resume != NULL) {
+		EndValue(ctx);
+	}
+
+	return resume;
+}
+
+/******************************************************************************
+* Function Name:  ResyncString
+*
+* Description:
+* Skip the rest of a string after an error in it, up to its close quote.
+*
+* Parameters:
+* text		uint8_t *		pointer to the first byte of the string to skip
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the byte after the close quote, to the line feed
+*				that stops a string that is not closed on its line, or end
+*
+* Notes:
+* A backslash skips the byte after it, so an escaped quote does not close
+* the string.
+*
+******************************************************************************/
+uint8_t *ResyncString(uint8_t *text, uint8_t *end) {
+	while (text < end && *text != CHAR_STRING_STOP && *text != CHAR_LINEFEED) {
+		text += (*text == CHAR_BACKSLASH && end - text >= 2) ? 2 : 1;
+	}
+	if (text < end && *text == CHAR_STRING_STOP) {
+		text++;
+	}
+
+	return text;
+}
+
+/******************************************************************************
+* Function Name:  ProcessValue
+*
+* Description:
+* Check the 7 possible values using the first byte of the value, which is
+* looked up in value_start so the switch is one jump table.  If it is one of
+* the 3 literal name tokens (true, false, null), a string or a number, call
+* the processing function to process the value.  If it is an object or array,
+* push the container and set the state to process its contents.  If the value
+* encountered is none of the 7 possibilities, set as invalid JSON.  A string,
+* number or literal name that was cut by the end of a chunk is continued.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t **		pointer to a pointer of starting text to lint
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the value has been parsed or opened
+*					RESULT_JSON_INCOMPLETE - more text is needed
+*					RESULT_JSON_INVALID - the text does not follow JSON
+*
+* Notes:
+* If the result of processing is invalid, ctx->ptr_invalid_json will be set to
+* the location of the error and ctx->error to the reason.
+*
+******************************************************************************/
+json_result_t ProcessValue(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_INVALID;
+	uint8_t value;				//json_value_t of the first byte
+	uint8_t literal;			//literal name, 0 false, 1 true, 2 null
+	PROFILE_START(*index);
+
+	if (ctx->token != TOKEN_NONE) {
+		if (ctx->token <= TOKEN_STRING_LAST) {
+			result = ProcessString(ctx, index, end);
+		} else if (ctx->token <= TOKEN_NUMBER_LAST) {
+			result = ProcessNumber(ctx, index, end);
+		} else {
+			result = ProcessLiteral(ctx, index, end);
+		}
+	} else if (ctx->tape != NULL && TapeValue(ctx, *index, end) != RESULT_JSON_SUCCESS) {
+		result = RESULT_JSON_INVALID;
+	} else if (*index < end) {
+		if (ctx->pointer != NULL) {
+			PointerValue(ctx, *index);
+		}
+		value = value_start[**index];
+		switch (value) {
+		case VALUE_OBJECT:
+			if ((result = PushContainer(ctx, *index, end, true)) == RESULT_JSON_SUCCESS &&
+				(ctx->key_arena == NULL || (result = KeysOpen(ctx, *index, end)) == RESULT_JSON_SUCCESS)) {
 				(*index)++;
+				ctx->stats.objects++;
+				ctx->state = STATE_OBJECT_FIRST;
 			}
-		} else {	//its zero
-			(*index)++;
-		}
-		if (strncmp(*index, STRING_DECIMAL, strlen(STRING_DECIMAL)) == 0){
-			(*index)++;
-			while (strchr(STRING_DIGIT_0_9, (*index)[0]) && strlen((*index))) {
+			break;
+		case VALUE_ARRAY:
+			if ((result = PushContainer(ctx, *index, end, false)) == RESULT_JSON_SUCCESS) {
 				(*index)++;
+				ctx->stats.arrays++;
+				ctx->state = STATE_ARRAY_FIRST;
+			}
+			break;
+		case VALUE_STRING:
+			ctx->stats.strings++;
+			result = ProcessString(ctx, index, end);
+			break;
+		case VALUE_NUMBER:
+			ctx->stats.numbers++;
+			ctx->token = TOKEN_NUMBER_START;
+			result = ProcessNumber(ctx, index, end);
+			break;
+		case VALUE_FALSE:
+		case VALUE_TRUE:
+		case VALUE_NULL:
+			ctx->stats.literals++;
+			literal = (uint8_t)(value - VALUE_FALSE);
+			if (MatchLiteral(*index, end, literal)) {
+				(*index) += literal_lengths[literal];
+				result = RESULT_JSON_SUCCESS;
+			} else {
+				ctx->token = (uint8_t)(TOKEN_LITERAL_FALSE + literal);
+				ctx->token_count = 0;
+				result = ProcessLiteral(ctx, index, end);
 			}
+			break;
+		default:
+			result = SetInvalid(ctx, *index, end, ERROR_JSON_LINT_INVALID_VALUE);
+			break;
 		}
-		if(strchr(STRING_EXPONENT_DIGITS, (*index)[0]) && strlen((*index))) {
-			(*index)++;
-			if (strncmp((*index), STRING_SIGN_POS, strlen(STRING_SIGN_POS)) == 0
-				|| strncmp((*index), STRING_SIGN_NEG, strlen(STRING_SIGN_NEG)) == 0
-				|| strchr(STRING_DIGIT_0_9, (*index)[0])) {
-				(*index)++;
-				while (strchr(STRING_DIGIT_0_9, (*index)[0]) && strlen((*index))) {
-					(*index)++;
+	} else {
+		result = SetInvalid(ctx, *index, end, ERROR_JSON_LINT_INVALID_VALUE);
+	}
+	if (result == RESULT_JSON_SUCCESS && ctx->state == STATE_VALUE) {
+		if (ctx->tape != NULL) {
+			TapeEnd(ctx, *index);
+		}
+		if (ctx->pointer != NULL) {
+			PointerEnd(ctx, *index);
+		}
+		EndValue(ctx);
+	}
+	PROFILE_CALL(PROFILE_JSON_LINT_VALUE, *index);
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  ProcessString
+*
+* Description:
+* Search for the start of a string --> ".  If found then process, including
+* escape characters.  Runs of text without a quote, backslash or control
+* character are skipped by ScanString().  Control characters must be escaped.
+* Text that is not ASCII must be UTF-8 and is checked by ScanUTF8().
+* If the string was cut by the end of a chunk, continue it from the escape or
+* text it was cut in.  When ctx->max_string is set, the scans stop one byte
+* past the limit so a long string is rejected without reading the rest of it.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t **		pointer to a pointer of starting text to lint
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the string has been parsed
+*					RESULT_JSON_NOT_FOUND - there is no string
+*					RESULT_JSON_INCOMPLETE - more text is needed
+*					RESULT_JSON_INVALID - the text does not follow JSON
+*
+* Notes:
+* If the result of processing is invalid, ctx->ptr_invalid_json will be set to
+* the location of the error and ctx->error to the reason.
+*
+******************************************************************************/
+json_result_t ProcessString(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	bool string_end = false;
+	uint8_t *text = *index;		//local copies so the loop works in registers
+	uint8_t token = ctx->token;
+	bool utf8_text = (token == TOKEN_STRING_UTF8);	//the rest of the string is checked by ScanUTF8()
+	uint8_t utf8_state;
+	uint8_t *limit = end;		//one past the first byte over ctx->max_string,
+								//or the end of the text
+	bool limited = false;		//the limit is before the end of the text
+	size_t remaining;
+	PROFILE_START(text);
+
+	if (token == TOKEN_NONE) {
+		if (IS_CHAR(text, end, CHAR_STRING_START)) {
+			ctx->token_offset = TEXT_OFFSET(ctx, text);
+			text++;
+			token = TOKEN_STRING_TEXT;
+		} else {
+			result = RESULT_JSON_NOT_FOUND;
+		}
+	}
+	if (ctx->max_string != 0 && result == RESULT_JSON_SUCCESS) {
+		//the open quote, max_string bytes of text and the close quote
+		remaining = ctx->token_offset + ctx->max_string + 2 - TEXT_OFFSET(ctx, text);
+		if (remaining <= (size_t)(end - text)) {
+			limit = text + remaining;
+			limited = true;
+		}
+	}
+	while (!string_end && result == RESULT_JSON_SUCCESS) {
+		if (token == TOKEN_STRING_TEXT && !utf8_text) {
+			text = ScanString(text, limit);
+		} else if (token == TOKEN_STRING_TEXT || token == TOKEN_STRING_UTF8) {
+			utf8_state = (token == TOKEN_STRING_UTF8) ? ctx->token_count : SCAN_UTF8_ACCEPT;
+			text = ScanUTF8(text, limit, &utf8_state);
+			token = (utf8_state == SCAN_UTF8_ACCEPT) ? TOKEN_STRING_TEXT : TOKEN_STRING_UTF8;
+			ctx->token_count = utf8_state;
+		}
+		if (token == TOKEN_STRING_UTF8 && ctx->token_count == SCAN_UTF8_INVALID) {
+			result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_UTF8);
+		} else if (limited && text == limit) {
+			//the byte before the limit is in the string and is not its close quote
+			result = SetInvalid(ctx, text - 1, end, ERROR_JSON_LINT_STRING_TOO_LONG);
+		} else if (text == end) {
+			result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_UNEXPECTED_END);
+		} else if (token == TOKEN_STRING_TEXT) {
+			if (*text == CHAR_STRING_STOP) {
+				text++;
+				string_end = true;
+			} else if (*text == CHAR_BACKSLASH) {
+				text++;
+				token = TOKEN_STRING_ESCAPE;
+			} else if (*text >= CHAR_ASCII_END) {
+				utf8_text = true;
+				token = TOKEN_STRING_UTF8;
+				ctx->token_count = SCAN_UTF8_ACCEPT;
+			} else {	//its a control character
+				result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_CONTROL_CHARACTER);
+			}
+		} else if (token == TOKEN_STRING_ESCAPE) {
+			if (!(char_class[*text] & CLASS_ESCAPE)) {
+				result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_ESCAPE);
+			} else if (*text == CHAR_UNICODE) {
+				text++;
+				token = TOKEN_STRING_UNICODE;
+				ctx->token_count = 0;
+			} else {
+				text++;
+				token = TOKEN_STRING_TEXT;
+			}
+		} else {	//TOKEN_STRING_UNICODE, 4 hex digits
+			if (ctx->token_count == 0 && limit - text >= 4 &&
+				(char_class[text[0]] & CLASS_HEX) &&
+				(char_class[text[1]] & CLASS_HEX) &&
+				(char_class[text[2]] & CLASS_HEX) &&
+				(char_class[text[3]] & CLASS_HEX)) {
+				text += 4;
+				token = TOKEN_STRING_TEXT;
+			} else if (char_class[*text] & CLASS_HEX) {
+				text++;
+				if (++ctx->token_count == 4) {
+					ctx->token_count = 0;
+					token = TOKEN_STRING_TEXT;
 				}
 			} else {
-				result = RESULT_JSON_INVALID;
-				ptr_invalid_json = *index;
+				result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_ESCAPE);
+			}
+		}
+	}
+	*index = text;
+	ctx->token = string_end ? TOKEN_NONE : token;
+	PROFILE_CALL(PROFILE_JSON_LINT_STRING, text);
+	if (string_end) {
+		//the bytes between the quotes
+		PROFILE_LENGTH(PROFILE_JSON_LINT_STRING, TEXT_OFFSET(ctx, text) - ctx->token_offset - 2);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  ProcessNumber
+*
+* Description:
+* Process the number defined in the JSON specification.  The number is an
+* optional minus sign, an integer part without leading zeros, an optional
+* fraction and an optional exponent.  The fraction and exponent need at least
+* one digit.  The part of the number being processed is kept in ctx->token, so
+* a number cut by the end of a chunk is continued from where it was cut.
+* When ctx->max_number is set, the digits are scanned up to one byte past the
+* limit.  Runs of digits are skipped 8 bytes at a time by ScanDigits().  When
+* ctx->classify_numbers is set, the value of the number is kept in
+* ctx->number from the runs and its class is found at the end of the number.
+* 
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t **		pointer to a pointer of starting text to lint
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the number has been parsed
+*					RESULT_JSON_INCOMPLETE - more text is needed
+*					RESULT_JSON_INVALID - the text does not follow JSON
+*
+* Notes:
+* If the result of processing is invalid, ctx->ptr_invalid_json will be set to
+* the location of the error and ctx->error to the reason.  The number must be
+* started by setting ctx->token to TOKEN_NUMBER_START.
+* 
+******************************************************************************/
+json_result_t ProcessNumber(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	bool number_end = false;
+	uint8_t *text = *index;		//local copies so the loop works in registers
+	uint8_t token = ctx->token;
+	uint8_t *limit = end;		//one past the first byte over ctx->max_number,
+								//or the end of the text
+	bool limited = false;		//the limit is before the end of the text
+	size_t remaining;
+	uint8_t *digits;			//first digit of a run
+	PROFILE_START(text);
+
+	if (token == TOKEN_NUMBER_START) {
+		ctx->token_offset = TEXT_OFFSET(ctx, text);
+		if (ctx->classify_numbers) {
+			memset(&ctx->number, 0, sizeof(ctx->number));
+			ctx->number.integer = true;
+		}
+	}
+	if (ctx->max_number != 0) {
+		remaining = ctx->token_offset + ctx->max_number + 1 - TEXT_OFFSET(ctx, text);
+		if (remaining <= (size_t)(end - text)) {
+			limit = text + remaining;
+			limited = true;
+		}
+	}
+	while (!number_end && result == RESULT_JSON_SUCCESS) {
+		if (limited && text == limit) {
+			result = SetInvalid(ctx, text - 1, end, ERROR_JSON_LINT_NUMBER_TOO_LONG);
+		} else if (text == end) {
+			//a number can only end with a digit
+			if (ctx->final && (token == TOKEN_NUMBER_INTEGER
+				|| token == TOKEN_NUMBER_INTEGER_END
+				|| token == TOKEN_NUMBER_FRACTION
+				|| token == TOKEN_NUMBER_EXPONENT_DIGITS)) {
+				number_end = true;
+			} else {
+				result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_NUMBER);
+			}
+		} else {
+			switch (token) {
+			case TOKEN_NUMBER_START:
+				if (*text == CHAR_SIGN_NEG) {
+					text++;
+					ctx->number.negative = true;
+				}
+				token = TOKEN_NUMBER_SIGN;
+				break;
+			case TOKEN_NUMBER_SIGN:
+				if (*text == CHAR_0) {
+					text++;
+					token = TOKEN_NUMBER_INTEGER_END;
+				} else if (char_class[*text] & CLASS_DIGIT) {
+					token = TOKEN_NUMBER_INTEGER;
+				} else {
+					result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_NUMBER);
+				}
+				break;
+			case TOKEN_NUMBER_INTEGER:
+				digits = text;
+				text = ScanDigits(text, limit);
+				if (ctx->classify_numbers) {
+					NumberDigits(&ctx->number, digits, text, false);
+				}
+				if (text < limit) {
+					token = TOKEN_NUMBER_INTEGER_END;
+				}
+				break;
+			case TOKEN_NUMBER_INTEGER_END:
+				if (*text == CHAR_DECIMAL) {
+					text++;
+					token = TOKEN_NUMBER_DECIMAL;
+					ctx->number.integer = false;
+				} else if (char_class[*text] & CLASS_EXPONENT) {
+					text++;
+					token = TOKEN_NUMBER_EXPONENT;
+					ctx->number.integer = false;
+				} else {
+					number_end = true;
+				}
+				break;
+			case TOKEN_NUMBER_DECIMAL:
+				if (char_class[*text] & CLASS_DIGIT) {
+					token = TOKEN_NUMBER_FRACTION;
+				} else {
+					result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_NUMBER);
+				}
+				break;
+			case TOKEN_NUMBER_FRACTION:
+				digits = text;
+				text = ScanDigits(text, limit);
+				if (ctx->classify_numbers) {
+					NumberDigits(&ctx->number, digits, text, true);
+				}
+				if (text < limit) {
+					if (char_class[*text] & CLASS_EXPONENT) {
+						text++;
+						token = TOKEN_NUMBER_EXPONENT;
+					} else {
+						number_end = true;
+					}
+				}
+				break;
+			case TOKEN_NUMBER_EXPONENT:
+				if (*text == CHAR_SIGN_POS || *text == CHAR_SIGN_NEG) {
+					ctx->number.exponent_negative = (*text == CHAR_SIGN_NEG);
+					text++;
+				}
+				token = TOKEN_NUMBER_EXPONENT_SIGN;
+				break;
+			case TOKEN_NUMBER_EXPONENT_SIGN:
+				if (char_class[*text] & CLASS_DIGIT) {
+					token = TOKEN_NUMBER_EXPONENT_DIGITS;
+				} else {
+					result = SetInvalid(ctx, text, end, ERROR_JSON_LINT_INVALID_NUMBER);
+				}
+				break;
+			default:	//TOKEN_NUMBER_EXPONENT_DIGITS
+				digits = text;
+				text = ScanDigits(text, limit);
+				if (ctx->classify_numbers) {
+					NumberExponent(&ctx->number, digits, text);
+				}
+				number_end = (text < limit);
+				break;
 			}
 		}
-	}else{
-		result = RESULT_JSON_NOT_FOUND;
+	}
+	if (number_end && ctx->classify_numbers) {
+		ctx->number.number_class = NumberClass(&ctx->number);
+	}
+	*index = text;
+	ctx->token = number_end ? TOKEN_NONE : token;
+	PROFILE_CALL(PROFILE_JSON_LINT_NUMBER, text);
+	if (number_end) {
+		PROFILE_LENGTH(PROFILE_JSON_LINT_NUMBER, TEXT_OFFSET(ctx, text) - ctx->token_offset);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  ProcessLiteral
+*
+* Description:
+* Process one of the 3 literal name tokens (true, false, null) selected by
+* ctx->token one byte at a time.  ctx->token_count is the number of bytes of 
+* the name matched so far, so a name cut by the end of a chunk is continued 
+* from where it was cut.  Names that are whole in the text are matched by 
+* ProcessValue() without calling this function.
+* 
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t **		pointer to a pointer of starting text to lint
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the literal name has been parsed
+*					RESULT_JSON_INCOMPLETE - more text is needed
+*					RESULT_JSON_INVALID - the text does not follow JSON
+*
+* Notes:
+* If the result of processing is invalid, ctx->ptr_invalid_json will be set to
+* the location of the first byte that does not match.
+* 
+******************************************************************************/
+json_result_t ProcessLiteral(json_lint_context_t *ctx, uint8_t **index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	const char *literal = literal_names[ctx->token - TOKEN_LITERAL_FALSE];
+	uint8_t length = literal_lengths[ctx->token - TOKEN_LITERAL_FALSE];
+	PROFILE_START(*index);
+
+	while (ctx->token_count < length && result == RESULT_JSON_SUCCESS) {
+		if (*index < end && **index == (uint8_t)literal[ctx->token_count]) {
+			(*index)++;
+			ctx->token_count++;
+		} else {
+			result = SetInvalid(ctx, *index, end, ERROR_JSON_LINT_INVALID_VALUE);
+		}
+	}
+	if (result == RESULT_JSON_SUCCESS) {
+		ctx->token = TOKEN_NONE;
+		ctx->token_count = 0;
+	}
+	PROFILE_CALL(PROFILE_JSON_LINT_LITERAL, *index);
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  PushContainer
+*
+* Description:
+* Open an object or array by pushing its type on the stack of the context.  
+* One bit is used for each level, 1 for an object and 0 for an array.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the open bracket
+* end		uint8_t *		pointer to one past the last byte of text
+* object	bool			true - the container is an object
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the container has been pushed
+*					RESULT_JSON_INVALID - the nesting is deeper than allowed
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_result_t PushContainer(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	bool object) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+
+	if (ctx->depth < ctx->max_depth) {
+		ctx->members[ctx->depth] = 1;
+		if (object) {
+			ctx->stack[ctx->depth / 64] |= STACK_BIT(ctx->depth);
+		} else {
+			ctx->stack[ctx->depth / 64] &= ~STACK_BIT(ctx->depth);
+		}
+		ctx->depth++;
+		if (ctx->depth > ctx->stats.max_depth) {
+			ctx->stats.max_depth = ctx->depth;
+		}
+	} else {
+		result = SetInvalid(ctx, index, end, ERROR_JSON_LINT_TOO_DEEP);
 	}
 
 	return result;
 }
 
+/******************************************************************************
+* Function Name:  NumberDigits
+*
+* Description:
+* Add a run of the integer or fraction digits of a number to its significand.
+*
+* Parameters:
+* number	json_lint_number_t *	value of the number so far
+* digits	uint8_t *		first digit of the run
+* end		uint8_t *		one past the last digit of the run
+* fraction	bool			the digits follow the decimal point
+*
+* Return Value:	None.
+*
+* Notes:
+* Leading zeros are not counted as digits.  A digit is added while the
+* significand fits in a uint64_t, so it holds 19 or 20 digits; the digits past
+* it only set number->more when they are not zero, and raise the scale when
+* they are before the decimal point.
+*
+******************************************************************************/
+void NumberDigits(json_lint_number_t *number, uint8_t *digits, uint8_t *end, bool fraction) {
+	uint32_t digit;
+
+	while (digits < end) {
+		digit = (uint32_t)(*digits - CHAR_0);
+		if (number->significand == 0 && digit == 0) {
+			number->scale -= fraction ? 1 : 0;
+		} else if (number->digits < NUMBER_DIGITS_MAX ||
+			(number->digits == NUMBER_DIGITS_MAX &&
+			number->significand <= (UINT64_MAX - digit) / 10)) {
+			number->significand = number->significand * 10 + digit;
+			number->digits++;
+			number->scale -= fraction ? 1 : 0;
+		} else {
+			number->more |= (digit != 0);
+			number->scale += fraction ? 0 : 1;
+		}
+		digits++;
+	}
+}
+
+/******************************************************************************
+* Function Name:  NumberExponent
+*
+* Description:
+* Add a run of the exponent digits of a number to its exponent.
+*
+* Parameters:
+* number	json_lint_number_t *	value of the number so far
+* digits	uint8_t *		first digit of the run
+* end		uint8_t *		one past the last digit of the run
+*
+* Return Value:	None.
+*
+* Notes:
+* The exponent stops growing at NUMBER_EXPONENT_CAP, far past the range of a
+* double, so it cannot overflow.
+*
+******************************************************************************/
+void NumberExponent(json_lint_number_t *number, uint8_t *digits, uint8_t *end) {
+	while (digits < end && number->exponent < NUMBER_EXPONENT_CAP) {
+		number->exponent = number->exponent * 10 + (uint32_t)(*digits - CHAR_0);
+		digits++;
+	}
+}
+
+/******************************************************************************
+* Function Name:  NumberClass
+*
+* Description:
+* Find the json_lint_number_class_t of a complete number.
+*
+* Parameters:
+* number	json_lint_number_t *	value of the number
+*
+* Return Value:
+* uint8_t		NUMBER_JSON_LINT_INT64 - an integer from INT64_MIN to INT64_MAX
+*				NUMBER_JSON_LINT_UINT64 - an integer up to UINT64_MAX
+*				NUMBER_JSON_LINT_DOUBLE_EXACT - the value is a double
+*				NUMBER_JSON_LINT_DOUBLE - the value may be rounded
+*				NUMBER_JSON_LINT_OVERFLOW - the value rounds to infinity or 0
+*
+* Notes:
+* Only a number written without a fraction or exponent is an integer class.
+* A double is exact when the significand with its factors of 2 taken out,
+* times or divided by the powers of 5 of the scale, is at most 2^53; this is
+* only tried when no digits were left out of the significand.  Near the ends
+* of the range of a double the first 19 digits decide.
+*
+******************************************************************************/
+uint8_t NumberClass(json_lint_number_t *number) {
+	uint8_t number_class = NUMBER_JSON_LINT_DOUBLE;
+	uint64_t significand = number->significand;
+	uint64_t leading;			//significand scaled to 19 digits
+	int64_t scale = number->scale;
+	int64_t decimal;			//power of ten of the first digit
+	bool more = number->more;
+	int64_t power;
+
+	if (number->integer && scale == 0 && !more &&
+		significand <= (number->negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX)) {
+		number_class = NUMBER_JSON_LINT_INT64;
+	} else if (number->integer && scale == 0 && !more && !number->negative) {
+		number_class = NUMBER_JSON_LINT_UINT64;
+	} else if (significand == 0) {
+		number_class = NUMBER_JSON_LINT_DOUBLE_EXACT;
+	} else {
+		scale += number->exponent_negative ? -(int64_t)number->exponent : (int64_t)number->exponent;
+		if (number->digits > NUMBER_DIGITS_MAX) {
+			more |= (significand % 10 != 0);
+			significand /= 10;
+			scale++;
+		}
+		leading = significand;
+		decimal = scale + NUMBER_DIGITS_MAX - 1;
+		while (leading < NUMBER_DIGITS_MIN_19) {
+			leading *= 10;
+			decimal--;
+		}
+		if (decimal > NUMBER_DECIMAL_MAX || decimal < NUMBER_DECIMAL_MIN ||
+			(decimal == NUMBER_DECIMAL_MAX && (leading > NUMBER_ROUND_UP_19 ||
+			(leading == NUMBER_ROUND_UP_19 && more))) ||
+			(decimal == NUMBER_DECIMAL_MIN && (leading < NUMBER_ROUND_DOWN_19 ||
+			(leading == NUMBER_ROUND_DOWN_19 && !more)))) {
+			number_class = NUMBER_JSON_LINT_OVERFLOW;
+		} else if (!more) {
+			while (significand % 10 == 0) {
+				significand /= 10;
+				scale++;
+			}
+			if (scale >= 0 && scale <= NUMBER_EXACT_POWER_MAX) {
+				while ((significand & 1) == 0) {
+					significand >>= 1;
+				}
+				for (power = 0; power < scale && significand <= NUMBER_EXACT_MAX; power++) {
+					significand *= 5;
+				}
+			} else if (scale < 0 && scale >= -NUMBER_EXACT_DIVIDE_MAX) {
+				for (power = 0; power < -scale && significand % 5 == 0; power++) {
+					significand /= 5;
+				}
+				significand = (power == -scale) ? significand : UINT64_MAX;
+				while ((significand & 1) == 0) {
+					significand >>= 1;
+				}
+			} else {
+				significand = UINT64_MAX;
+			}
+			if (significand <= NUMBER_EXACT_MAX) {
+				number_class = NUMBER_JSON_LINT_DOUBLE_EXACT;
+			}
+		}
+	}
+
+	return number_class;
+}
+
+/******************************************************************************
+* Function Name:  EndValue
+*
+* Description:
+* Set the state after a complete value from the container the value is in.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void EndValue(json_lint_context_t *ctx) {
+	if (ctx->depth == 0) {
+		ctx->state = STATE_DONE;
+	} else if (ctx->stack[(ctx->depth - 1) / 64] & STACK_BIT(ctx->depth - 1)) {
+		ctx->state = STATE_OBJECT_SEPARATOR;
+	} else {
+		ctx->state = STATE_ARRAY_SEPARATOR;
+	}
+}
+
+/******************************************************************************
+* Function Name:  TapeValue
+*
+* Description:
+* Record the value that starts at the index in the tape of the context.  A
+* string is recorded as a key when a key is expected.  The open bracket of an
+* object or array is linked to the open bracket it is inside of until its
+* close bracket is found.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the first byte of the value
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the value has been recorded, or no
+*					value starts at the index
+*					RESULT_JSON_INVALID - the tape is full
+*
+* Notes:
+* The bytes of a string, number or literal name are set by TapeEnd() once the
+* end of the value is found.
+*
+******************************************************************************/
+json_result_t TapeValue(json_lint_context_t *ctx, uint8_t *index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	uint8_t type = TAPE_NONE;
+	json_lint_tape_t *entry;
+
+	if (index < end && ctx->state == STATE_OBJECT_KEY) {
+		type = (*index == CHAR_STRING_START) ? TAPE_JSON_LINT_KEY : TAPE_NONE;
+	} else if (index < end) {
+		type = value_tape_types[value_start[*index]];
+	}
+	//when no value starts at the index, the caller finds the error
+	if (type != TAPE_NONE && ctx->tape_count == ctx->tape_size) {
+		result = SetInvalid(ctx, index, end, ERROR_JSON_LINT_TAPE_FULL);
+	} else if (type != TAPE_NONE) {
+		entry = &ctx->tape[ctx->tape_count];
+		entry->offset = TEXT_OFFSET(ctx, index);
+		entry->link = 0;
+		entry->type = type;
+		entry->number_class = NUMBER_JSON_LINT_NONE;
+		if (type == TAPE_JSON_LINT_OBJECT_BEGIN || type == TAPE_JSON_LINT_ARRAY_BEGIN) {
+			entry->link = ctx->tape_open;
+			ctx->tape_open = ctx->tape_count;
+		}
+		ctx->tape_count++;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  TapeClose
+*
+* Description:
+* Record the close bracket of the innermost open object or array in the tape
+* of the context and link the open and close brackets to each other.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the close bracket
+* end		uint8_t *		pointer to one past the last byte of text
+* type		json_lint_tape_type_t	TAPE_JSON_LINT_OBJECT_END or
+*									TAPE_JSON_LINT_ARRAY_END
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the bracket has been recorded
+*					RESULT_JSON_INVALID - the tape is full
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_result_t TapeClose(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	json_lint_tape_type_t type) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	json_lint_tape_t *entry;
+	size_t open = ctx->tape_open;
+
+	if (ctx->tape_count == ctx->tape_size) {
+		result = SetInvalid(ctx, index, end, ERROR_JSON_LINT_TAPE_FULL);
+	} else {
+		entry = &ctx->tape[ctx->tape_count];
+		entry->offset = TEXT_OFFSET(ctx, index);
+		entry->link = open;
+		entry->type = (uint8_t)type;
+		entry->number_class = NUMBER_JSON_LINT_NONE;
+		ctx->tape_open = ctx->tape[open].link;
+		ctx->tape[open].link = ctx->tape_count;
+		ctx->tape_count++;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  TapeEnd
+*
+* Description:
+* Set the bytes of the string, number or literal name last recorded in the
+* tape of the context, and the class of a number.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to one past the last byte of the value
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void TapeEnd(json_lint_context_t *ctx, uint8_t *index) {
+	json_lint_tape_t *entry = &ctx->tape[ctx->tape_count - 1];
+
+	entry->link = TEXT_OFFSET(ctx, index) - entry->offset;
+	if (entry->type == TAPE_JSON_LINT_NUMBER) {
+		entry->number_class = ctx->number.number_class;
+	}
+}
+
+/******************************************************************************
+* Function Name:  PointerValue
+*
+* Description:
+* Follow the JSON pointer being looked up into the value that starts at the
+* index.  The value is the one named by the pointer when it is the value of
+* the key or the array index of the reference token, or the whole text.  It
+* is then the value found, or the container the next reference token is
+* looked up in.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the first byte of the value
+*
+* Return Value:	None.
+*
+* Notes:
+* ctx->pointer is set to NULL when the pointer names a member of a string,
+* number or literal name, as the text has no such value.
+*
+******************************************************************************/
+void PointerValue(json_lint_context_t *ctx, uint8_t *index) {
+	json_lint_pointer_t *lookup = ctx->pointer;
+	bool named = (lookup->state == POINTER_VALUE);
+
+	if (lookup->state == POINTER_SEARCH && !lookup->object && ctx->depth == lookup->depth) {
+		named = (lookup->count++ == lookup->index);
+	}
+	if (named && lookup->next == lookup->end) {
+		lookup->state = POINTER_TARGET;
+		lookup->depth = ctx->depth;
+		lookup->offset = TEXT_OFFSET(ctx, index);
+	} else if (named && (*index == CHAR_OBJECT_START || *index == CHAR_ARRAY_START)) {
+		lookup->state = POINTER_SEARCH;
+		lookup->depth = ctx->depth + 1;
+		lookup->object = (*index == CHAR_OBJECT_START);
+		lookup->count = 0;
+		lookup->token = lookup->next + 1;
+		lookup->token_end = memchr(lookup->token, CHAR_POINTER_SEPARATOR, (size_t)(lookup->end - lookup->token));
+		if (lookup->token_end == NULL) {
+			lookup->token_end = lookup->end;
+		}
+		lookup->next = lookup->token_end;
+		if (!lookup->object && !PointerIndex(lookup->token, lookup->token_end, &lookup->index)) {
+			ctx->pointer = NULL;
+		}
+	} else if (named) {
+		ctx->pointer = NULL;
+	}
+}
+
+/******************************************************************************
+* Function Name:  PointerKey
+*
+* Description:
+* Compare a key of the object being searched with the reference token of the
+* JSON pointer being looked up.  If they are the same, the value of the
+* member is named by the pointer.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* key		uint8_t *		pointer to the open quote of the key
+* key_end	uint8_t *		pointer to one past the close quote of the key
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void PointerKey(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end) {
+	json_lint_pointer_t *lookup = ctx->pointer;
+
+	if (lookup->state == POINTER_SEARCH && ctx->depth == lookup->depth &&
+		MatchKey(key + 1, key_end - 1, lookup->token, lookup->token_end)) {
+		lookup->state = POINTER_VALUE;
+	}
+}
+
+/******************************************************************************
+* Function Name:  PointerEnd
+*
+* Description:
+* Check the end of a value against the JSON pointer being looked up.  The end
+* of the value found gives its length, and the end of the container searched
+* shows the reference token is not in it.  Either ends the lookup.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to one past the last byte of the value
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void PointerEnd(json_lint_context_t *ctx, uint8_t *index) {
+	json_lint_pointer_t *lookup = ctx->pointer;
+
+	if (lookup->state == POINTER_TARGET && ctx->depth == lookup->depth) {
+		lookup->length = TEXT_OFFSET(ctx, index) - lookup->offset;
+		ctx->pointer = NULL;
+	} else if (lookup->state == POINTER_SEARCH && ctx->depth < lookup->depth) {
+		ctx->pointer = NULL;
+	}
+}
+
+/******************************************************************************
+* Function Name:  PointerIndex
+*
+* Description:
+* Convert a reference token of a JSON pointer to an array index.  The index
+* is decimal digits without a leading zero.
+*
+* Parameters:
+* token			const uint8_t *		pointer to the reference token
+* token_end		const uint8_t *		pointer to one past the reference token
+* index			size_t *			set to the array index
+*
+* Return Value:
+* bool		true - the token is an array index
+*
+* Notes:
+* The token - names the element after the last one, which is never in the
+* text.
+*
+******************************************************************************/
+bool PointerIndex(const uint8_t *token, const uint8_t *token_end, size_t *index) {
+	bool valid = (token < token_end && (*token != CHAR_0 || token_end - token == 1));
+
+	*index = 0;
+	while (valid && token < token_end) {
+		valid = ((char_class[*token] & CLASS_DIGIT) && *index <= (SIZE_MAX - 9) / 10);
+		*index = *index * 10 + (size_t)(*token - CHAR_0);
+		token++;
+	}
+
+	return valid;
+}
+
+/******************************************************************************
+* Function Name:  MatchKey
+*
+* Description:
+* Compare the text of a key with a reference token of a JSON pointer.  The
+* escapes of the key are decoded to UTF-8 and ~0 and ~1 of the token to ~ and
+* /.
+*
+* Parameters:
+* key			uint8_t *			pointer to the text of a valid key, after the
+*									open quote
+* key_end		uint8_t *			pointer to the close quote of the key
+* token			const uint8_t *		pointer to the reference token
+* token_end		const uint8_t *		pointer to one past the reference token
+*
+* Return Value:
+* bool		true - the key and token are the same text
+*
+* Notes:	None.
+*
+******************************************************************************/
+bool MatchKey(uint8_t *key, uint8_t *key_end, const uint8_t *token, const uint8_t *token_end) {
+	bool match = true;
+	uint8_t bytes[4];		//UTF-8 of one character of the key
+	uint8_t byte;
+	uint32_t count;
+
+	while (match && key < key_end) {
+		if (*key == CHAR_BACKSLASH) {
+			key++;
+			count = DecodeEscape(&key, key_end, bytes);
+		} else {
+			bytes[0] = *key++;
+			count = 1;
+		}
+		for (uint32_t i = 0; match && i < count; i++) {
+			match = (token < token_end);
+			byte = match ? *token++ : 0;
+			if (byte == CHAR_POINTER_ESCAPE && token < token_end && (*token == '0' || *token == '1')) {
+				byte = (*token++ == '0') ? CHAR_POINTER_ESCAPE : CHAR_POINTER_SEPARATOR;
+			}
+			match = match && (byte == bytes[i]);
+		}
+	}
+
+	return match && token == token_end;
+}
+
+/******************************************************************************
+* Function Name:  DecodeEscape
+*
+* Description:
+* Decode the escape of a valid string to the UTF-8 of the character.  A \u
+* escape of a high surrogate followed by a \u escape of a low surrogate is
+* one character.
+*
+* Parameters:
+* key			uint8_t **		pointer to a pointer to the byte after the
+*								backslash, set to the byte after the escape
+* key_end		uint8_t *		pointer to the end of the string text
+* bytes			uint8_t *		set to the 1 to 4 bytes of the character
+*
+* Return Value:
+* uint32_t		number of bytes of the character
+*
+* Notes:
+* A surrogate that is not part of a pair is given as the 3 bytes it would
+* have, which no valid UTF-8 pointer matches.
+*
+******************************************************************************/
+uint32_t DecodeEscape(uint8_t **key, uint8_t *key_end, uint8_t *bytes) {
+	uint32_t count = 1;
+	uint32_t code;
+	uint8_t *text = *key;
+
+	switch (*text++) {
+	case 'b': bytes[0] = '\b'; break;
+	case 'f': bytes[0] = '\f'; break;
+	case 'n': bytes[0] = '\n'; break;
+	case 'r': bytes[0] = '\r'; break;
+	case 't': bytes[0] = '\t'; break;
+	case CHAR_UNICODE:
+		code = HexValue(text);
+		text += 4;
+		if (code >= 0xD800 && code <= 0xDBFF && key_end - text >= 6 &&
+			text[0] == CHAR_BACKSLASH && text[1] == CHAR_UNICODE &&
+			HexValue(text + 2) >= 0xDC00 && HexValue(text + 2) <= 0xDFFF) {
+			code = 0x10000 + ((code - 0xD800) << 10) + (HexValue(text + 2) - 0xDC00);
+			text += 6;
+		}
+		if (code < 0x80) {
+			bytes[0] = (uint8_t)code;
+		} else if (code < 0x800) {
+			bytes[0] = (uint8_t)(0xC0 | (code >> 6));
+			bytes[1] = (uint8_t)(0x80 | (code & 0x3F));
+			count = 2;
+		} else if (code < 0x10000) {
+			bytes[0] = (uint8_t)(0xE0 | (code >> 12));
+			bytes[1] = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+			bytes[2] = (uint8_t)(0x80 | (code & 0x3F));
+			count = 3;
+		} else {
+			bytes[0] = (uint8_t)(0xF0 | (code >> 18));
+			bytes[1] = (uint8_t)(0x80 | ((code >> 12) & 0x3F));
+			bytes[2] = (uint8_t)(0x80 | ((code >> 6) & 0x3F));
+			bytes[3] = (uint8_t)(0x80 | (code & 0x3F));
+			count = 4;
+		}
+		break;
+	default:	//", \ or /
+		bytes[0] = text[-1];
+		break;
+	}
+	*key = text;
+
+	return count;
+}
+
+/******************************************************************************
+* Function Name:  HexValue
+*
+* Description:
+* Convert the 4 hex digits of a \u escape to the code unit.
+*
+* Parameters:
+* digits	uint8_t *		pointer to 4 valid hex digits
+*
+* Return Value:
+* uint32_t		code unit of 0 to 0xFFFF
+*
+* Notes:	None.
+*
+******************************************************************************/
+uint32_t HexValue(uint8_t *digits) {
+	uint32_t value = 0;
+
+	for (uint32_t i = 0; i < 4; i++) {
+		value = (value << 4) | (uint32_t)((digits[i] <= '9') ? digits[i] - '0' : (digits[i] | 0x20) - 'a' + 10);
+	}
+
+	return value;
+}
+
+/******************************************************************************
+* Function Name:  KeysOpen
+*
+* Description:
+* Push an empty key table for an object that is opened on the arena of the
+* context.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the open bracket
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the table has been pushed
+*					RESULT_JSON_INVALID - the memory could not be allocated
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_result_t KeysOpen(json_lint_context_t *ctx, uint8_t *index, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	json_lint_arena_t *arena = ctx->key_arena;
+	size_t size = sizeof(key_table_t) + KEY_TABLE_SLOTS * sizeof(key_slot_t);
+	key_table_t *table;
+
+	if (ArenaReserve(&arena->tables, &arena->tables_size, arena->tables_used + size)) {
+		table = (key_table_t *)(arena->tables + arena->tables_used);
+		memset(table, 0, size);
+		table->parent = arena->table;
+		table->keys_mark = arena->keys_used;
+		table->mask = KEY_TABLE_SLOTS - 1;
+		arena->table = arena->tables_used;
+		arena->tables_used += size;
+	} else {
+		result = SetInvalid(ctx, index, end, ERROR_JSON_LINT_NO_MEMORY);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  KeysClose
+*
+* Description:
+* Pop the key table and keys of the innermost object from the arena of the
+* context when the object is closed.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void KeysClose(json_lint_context_t *ctx) {
+	json_lint_arena_t *arena = ctx->key_arena;
+	key_table_t *table = (key_table_t *)(arena->tables + arena->table);
+
+	arena->tables_used = arena->table;
+	arena->keys_used = table->keys_mark;
+	arena->table = table->parent;
+}
+
+/******************************************************************************
+* Function Name:  KeysCut
+*
+* Description:
+* Keep the part of a key that is cut by the end of a chunk after the keys of
+* the arena of the context, as the chunk is not kept.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* key		uint8_t *		pointer to the open quote of the key, or to the
+*							start of the chunk for a key already cut
+* key_end	uint8_t *		pointer to the end of the chunk
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_INCOMPLETE - the part has been kept
+*					RESULT_JSON_INVALID - the memory could not be allocated
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_result_t KeysCut(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end, uint8_t *end) {
+	json_result_t result = RESULT_JSON_INCOMPLETE;
+	json_lint_arena_t *arena = ctx->key_arena;
+	size_t length;
+
+	if (!arena->cut) {
+		arena->key_offset = TEXT_OFFSET(ctx, key);
+		arena->cut = true;
+		key++;
+	}
+	length = (size_t)(key_end - key);
+	if (ArenaReserve(&arena->keys, &arena->keys_size, arena->keys_used + arena->cut_length + length)) {
+		memcpy(arena->keys + arena->keys_used + arena->cut_length, key, length);
+		arena->cut_length += length;
+	} else {
+		result = SetInvalid(ctx, key, end, ERROR_JSON_LINT_NO_MEMORY);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  KeysAdd
+*
+* Description:
+* Add a key to the table of the innermost object in the arena of the
+* context.  The key is copied after the keys of the arena and its escapes
+* are decoded, so the same key written with different escapes is found.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* key		uint8_t *		pointer to the open quote of a valid key, or to the
+*							start of the chunk for a key that was cut
+* key_end	uint8_t *		pointer to one past the close quote of the key
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* json_result_t		RESULT_JSON_SUCCESS - the key has been added
+*					RESULT_JSON_INVALID - the object already has the key, or
+*					the memory could not be allocated
+*
+* Notes:
+* A duplicate key is reported at the open quote of the second key.  When the
+* key was cut by the end of a chunk, ctx->ptr_invalid_json points to the part
+* of the key in the chunk and ctx->offset_invalid_json to the open quote.
+*
+******************************************************************************/
+json_result_t KeysAdd(json_lint_context_t *ctx, uint8_t *key, uint8_t *key_end, uint8_t *end) {
+	json_result_t result = RESULT_JSON_SUCCESS;
+	json_lint_arena_t *arena = ctx->key_arena;
+	uint8_t *error = key;
+	uint8_t *text;
+	uint8_t *read;
+	uint8_t *write;
+	uint8_t bytes[4];
+	size_t length;
+	uint32_t count;
+	uint32_t hash = KEY_HASH_BASIS;
+
+	if (!arena->cut) {
+		arena->key_offset = TEXT_OFFSET(ctx, key);
+		key++;
+	}
+	length = (size_t)(key_end - 1 - key);
+	if (!ArenaReserve(&arena->keys, &arena->keys_size, arena->keys_used + arena->cut_length + length)) {
+		result = SetInvalid(ctx, error, end, ERROR_JSON_LINT_NO_MEMORY);
+	} else {
+		text = arena->keys + arena->keys_used;
+		memcpy(text + arena->cut_length, key, length);
+		length += arena->cut_length;
+		arena->cut_length = 0;
+		arena->cut = false;
+		if (memchr(text, CHAR_BACKSLASH, length) != NULL) {
+			read = text;
+			write = text;
+			while (read < text + length) {	//decoded text is never longer
+				if (*read == CHAR_BACKSLASH) {
+					read++;
+					count = DecodeEscape(&read, text + length, bytes);
+					memcpy(write, bytes, count);
+					write += count;
+				} else {
+					*write++ = *read++;
+				}
+			}
+			length = (size_t)(write - text);
+		}
+		for (size_t i = 0; i < length; i++) {
+			hash = (hash ^ text[i]) * KEY_HASH_PRIME;
+		}
+		hash = (hash == 0) ? 1 : hash;
+		if (!KeysInsert(arena, length, hash)) {
+			result = SetInvalid(ctx, error, end, ERROR_JSON_LINT_DUPLICATE_KEY);
+			ctx->offset_invalid_json = arena->key_offset;
+		} else if (!KeysGrow(arena)) {
+			result = SetInvalid(ctx, error, end, ERROR_JSON_LINT_NO_MEMORY);
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  KeysInsert
+*
+* Description:
+* Insert the key after the keys of the arena in the table of the innermost
+* object with open addressing.
+*
+* Parameters:
+* arena		json_lint_arena_t *		arena with the key after its keys
+* length	size_t					bytes of the key
+* hash		uint32_t				hash of the key, not 0
+*
+* Return Value:
+* bool		true - the key has been inserted
+*			false - the table already has the key
+*
+* Notes:	None.
+*
+******************************************************************************/
+bool KeysInsert(json_lint_arena_t *arena, size_t length, uint32_t hash) {
+	bool inserted = true;
+	key_table_t *table = (key_table_t *)(arena->tables + arena->table);
+	key_slot_t *slots = (key_slot_t *)(table + 1);
+	uint8_t *key = arena->keys + arena->keys_used;
+	uint32_t slot = hash & table->mask;
+
+	while (inserted && slots[slot].hash != 0) {
+		inserted = !(slots[slot].hash == hash && slots[slot].length == length &&
+			memcmp(arena->keys + slots[slot].offset, key, length) == 0);
+		slot = (slot + 1) & table->mask;
+	}
+	if (inserted) {
+		slots[slot].offset = arena->keys_used;
+		slots[slot].length = length;
+		slots[slot].hash = hash;
+		arena->keys_used += length;
+		table->count++;
+	}
+
+	return inserted;
+}
+
+/******************************************************************************
+* Function Name:  KeysGrow
+*
+* Description:
+* Double the table of the innermost object when it is half full.  It is the
+* last table of the arena, so it is doubled in place: the doubled table is
+* built after the tables and then moved down.
+*
+* Parameters:
+* arena		json_lint_arena_t *		arena of the table
+*
+* Return Value:
+* bool		true - the table has room for the next key
+*			false - the memory could not be allocated
+*
+* Notes:	None.
+*
+******************************************************************************/
+bool KeysGrow(json_lint_arena_t *arena) {
+	bool grown = true;
+	key_table_t *table = (key_table_t *)(arena->tables + arena->table);
+	key_slot_t *slots;
+	key_slot_t *doubled;
+	uint32_t mask = table->mask * 2 + 1;
+	uint32_t slot;
+	size_t size = sizeof(key_table_t) + ((size_t)mask + 1) * sizeof(key_slot_t);
+	bool full = (table->count * 2 > table->mask);
+
+	if (full && !ArenaReserve(&arena->tables, &arena->tables_size, arena->tables_used + size)) {
+		grown = false;
+	} else if (full) {
+		table = (key_table_t *)(arena->tables + arena->table);
+		slots = (key_slot_t *)(table + 1);
+		doubled = (key_slot_t *)(arena->tables + arena->tables_used + sizeof(key_table_t));
+		memset(doubled, 0, ((size_t)mask + 1) * sizeof(key_slot_t));
+		for (uint32_t i = 0; i <= table->mask; i++) {
+			if (slots[i].hash != 0) {
+				slot = slots[i].hash & mask;
+				while (doubled[slot].hash != 0) {
+					slot = (slot + 1) & mask;
+				}
+				doubled[slot] = slots[i];
+			}
+		}
+		memmove(slots, doubled, ((size_t)mask + 1) * sizeof(key_slot_t));
+		table->mask = mask;
+		arena->tables_used = arena->table + size;
+	}
+
+	return grown;
+}
+
+/******************************************************************************
+* Function Name:  ArenaReserve
+*
+* Description:
+* Grow a block of memory of an arena to hold at least the bytes needed.  The
+* size is doubled so a stack that grows is copied a few times only.
+*
+* Parameters:
+* memory	uint8_t **		pointer to the block, set to the grown block
+* size		size_t *		bytes allocated for the block, set to the new size
+* needed	size_t			bytes the block must hold
+*
+* Return Value:
+* bool		true - the block holds the bytes needed
+*
+* Notes:
+* The block is not changed if it can not be grown.  A block not yet
+* allocated is allocated even if no bytes are needed, so the keys of an
+* arena can be copied and searched from the first key on.
+*
+******************************************************************************/
+bool ArenaReserve(uint8_t **memory, size_t *size, size_t needed) {
+	bool reserved = (needed <= *size && *memory != NULL);
+	size_t grown = (*size > 0) ? *size : 256;
+	uint8_t *block;
+
+	if (!reserved) {
+		while (grown < needed) {
+			grown *= 2;
+		}
+		block = realloc(*memory, grown);
+		if (block != NULL) {
+			*memory = block;
+			*size = grown;
+			reserved = true;
+		}
+	}
+
+	return reserved;
+}
+
+/******************************************************************************
+* Function Name:  MinifyCopy
+*
+* Description:
+* Write the text of the chunk from ctx->minify_span up to the index to the
+* minified text.
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to one past the last byte to write
+*
+* Return Value:	None.
+*
+* Notes:
+* When compacting in place the text is not moved until the first run of
+* whitespace is left out.
+*
+******************************************************************************/
+void MinifyCopy(json_lint_context_t *ctx, uint8_t *index) {
+	size_t length = (size_t)(index - ctx->minify_span);
+
+	if (ctx->minify + ctx->minify_length != ctx->minify_span) {
+		memmove(ctx->minify + ctx->minify_length, ctx->minify_span, length);
+	}
+	ctx->minify_length += length;
+}
+
+/******************************************************************************
+* Function Name:  MatchLiteral
+*
+* Description:
+* Compare the text at the index with a literal name whose first byte has
+* already been matched, with one 32-bit compare of its last 4 bytes.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte of the literal name
+* end		uint8_t *		pointer to one past the last byte of text
+* literal	uint8_t			literal name, in the order of literal_names
+*
+* Return Value:
+* bool		true - the text starts with the whole literal name
+*
+* Notes:
+* Every literal name is 4 or 5 bytes, so the last 4 bytes together with the
+* first byte cover the whole name.  The words are loaded with memcpy(), which
+* compiles to one unaligned load on targets that have one.
+*
+******************************************************************************/
+bool MatchLiteral(uint8_t *index, uint8_t *end, uint8_t literal) {
+	size_t length = literal_lengths[literal];
+	uint32_t text;
+	uint32_t name;
+	bool match = false;
+
+	if ((size_t)(end - index) >= length) {
+		memcpy(&text, index + length - sizeof(text), sizeof(text));
+		memcpy(&name, literal_names[literal] + length - sizeof(name), sizeof(name));
+		match = (text == name);
+	}
+
+	return match;
+}
+
+/******************************************************************************
+* Function Name:  SetInvalid
+*
+* Description:
+* Record the location and reason of the first error found in the text.  An
+* error at the end of the text is always reported as the text ending early,
+* unless more text can still be given with LintJSONFeed().
+*
+* Parameters:
+* ctx		json_lint_context_t *	lint context of the text
+* index		uint8_t *		pointer to the location of the error
+* end		uint8_t *		pointer to one past the last byte of text
+* error		json_lint_error_t	reason for the error
+*
+* Return Value:
+* json_result_t		RESULT_JSON_INVALID - the error has been recorded
+*					RESULT_JSON_INCOMPLETE - the error is at the end of a 
+*					chunk, more text is needed
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_result_t SetInvalid(json_lint_context_t *ctx, uint8_t *index, uint8_t *end,
+	json_lint_error_t error) {
+	json_result_t result = RESULT_JSON_INVALID;
+
+	if (index == end && !ctx->final) {
+		result = RESULT_JSON_INCOMPLETE;
+	} else if (ctx->error == ERROR_JSON_LINT_NONE) {
+		ctx->ptr_invalid_json = index;
+		ctx->offset_invalid_json = TEXT_OFFSET(ctx, index);
+		ctx->error = (index == end && error != ERROR_JSON_LINT_EMPTY) ? ERROR_JSON_LINT_UNEXPECTED_END : error;
+	}
+
+	return result;
+}
@@ -31,7 +31,11 @@
 * Notes:
 * The Linting of JSON is preformed according to the ECMA-404 standard, 2nd
 * edition.  Any deviations or details added to the standard are listed below:
-*		- None.
+*		- None, unless ctx->dialect is DIALECT_JSON_LINT_RELAXED, which also
+*		  accepts line comments from // to the end of the line and block
+*		  comments from slash star to star slash where whitespace is
+*		  allowed, and a comma after the last member of an object or value
+*		  of an array.
 * 
 * References:
 * The JSON Data Interchange Syntax, ECMA-404, 2nd Edition, December 2017
@@ -46,25 +50,234 @@
 ******************************************************************************/
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdio.h>
 
+/******************************************************************************
+* Defines
+******************************************************************************/
+#ifndef JSON_LINT_DEPTH_MAX
+#define JSON_LINT_DEPTH_MAX		1024	//deepest nesting a context can hold
+#endif
+
 /******************************************************************************
 * Type Definitions
 ******************************************************************************/
 typedef enum {
 	RESULT_JSON_LINT_SUCCESS,
 	RESULT_JSON_LINT_INVALID,
+	RESULT_JSON_LINT_INCOMPLETE,		//no error so far, LintJSONFeed() needs more
 } json_lint_result_t;
 
+typedef enum {
+	ERROR_JSON_LINT_NONE,
+	ERROR_JSON_LINT_EMPTY,				//there is no text to lint
+	ERROR_JSON_LINT_UNEXPECTED_END,		//the text ended inside a value
+	ERROR_JSON_LINT_INVALID_VALUE,		//no value starts at the location
+	ERROR_JSON_LINT_EXPECTED_KEY,		//object member does not start with a string
+	ERROR_JSON_LINT_EXPECTED_COLON,		//object key is not followed by a colon
+	ERROR_JSON_LINT_EXPECTED_SEPARATOR,	//value is not followed by a comma or close
+	ERROR_JSON_LINT_INVALID_ESCAPE,		//backslash is not followed by a valid escape
+	ERROR_JSON_LINT_CONTROL_CHARACTER,	//control character in a string is not escaped
+	ERROR_JSON_LINT_INVALID_NUMBER,		//number is missing a digit
+	ERROR_JSON_LINT_TRAILING_TEXT,		//text follows the JSON value
+	ERROR_JSON_LINT_TOO_DEEP,			//nesting is deeper than max_depth
+	ERROR_JSON_LINT_NO_MEMORY,			//memory for the results could not be allocated
+	ERROR_JSON_LINT_INVALID_UTF8,		//string text is not valid UTF-8
+	ERROR_JSON_LINT_TAPE_FULL,			//the values do not fit in ctx->tape_size
+	ERROR_JSON_LINT_DUPLICATE_KEY,		//object has the key of an earlier member
+	ERROR_JSON_LINT_TOO_LARGE,			//text is longer than max_length
+	ERROR_JSON_LINT_STRING_TOO_LONG,	//string is longer than max_string
+	ERROR_JSON_LINT_NUMBER_TOO_LONG,	//number is longer than max_number
+	ERROR_JSON_LINT_TOO_MANY_MEMBERS,	//object or array has more than max_members
+	ERROR_JSON_LINT_OUTPUT_FULL,		//the text does not fit in ctx->minify_size
+	ERROR_JSON_LINT_INVALID_COMMENT,	//slash is not followed by / or *
+} json_lint_error_t;
+
+typedef enum {
+	DIALECT_JSON_LINT_ECMA404,			//strict JSON
+	DIALECT_JSON_LINT_RELAXED,			//comments and trailing commas
+} json_lint_dialect_t;
+
+typedef enum {
+	TAPE_JSON_LINT_OBJECT_BEGIN,		//open curly bracket
+	TAPE_JSON_LINT_OBJECT_END,			//close curly bracket
+	TAPE_JSON_LINT_ARRAY_BEGIN,			//open square bracket
+	TAPE_JSON_LINT_ARRAY_END,			//close square bracket
+	TAPE_JSON_LINT_KEY,					//string that is the key of a member
+	TAPE_JSON_LINT_STRING,				//string value
+	TAPE_JSON_LINT_NUMBER,
+	TAPE_JSON_LINT_TRUE,
+	TAPE_JSON_LINT_FALSE,
+	TAPE_JSON_LINT_NULL,
+} json_lint_tape_type_t;
+
+typedef enum {
+	NUMBER_JSON_LINT_NONE,				//not a number, or numbers are not classified
+	NUMBER_JSON_LINT_INT64,				//integer that fits in an int64_t
+	NUMBER_JSON_LINT_UINT64,			//integer past INT64_MAX that fits in a uint64_t
+	NUMBER_JSON_LINT_DOUBLE_EXACT,		//value is exactly a double
+	NUMBER_JSON_LINT_DOUBLE,			//value may be rounded to the nearest double
+	NUMBER_JSON_LINT_OVERFLOW,			//value is too large for a double, or so
+										//small it rounds to 0
+} json_lint_number_class_t;
+
+typedef struct {
+	size_t offset;				//offset of the value or bracket from the start
+								//of text
+	size_t link;				//begin and end: tape index of the matching
+								//bracket, others: bytes of the value
+	uint8_t type;				//json_lint_tape_type_t
+	uint8_t number_class;		//number: json_lint_number_class_t
+} json_lint_tape_t;
+
+typedef struct {
+	size_t offset_invalid_json;	//offset of invalid json from the start of text
+	json_lint_error_t error;	//reason the json is invalid
+} json_lint_diagnostic_t;
+
+typedef struct {
+	size_t offset;				//offset the line and column are of
+	size_t line;				//line of the offset, from 1, 0 before the first
+								//call of LintJSONLocate()
+	size_t column;				//byte of the offset in its line, from 1
+	size_t line_offset;			//offset of the first byte of the line
+} json_lint_location_t;
+
+typedef struct {
+	uint32_t objects;			//number of objects
+	uint32_t arrays;			//number of arrays
+	uint32_t keys;				//number of object keys
+	uint32_t strings;			//number of string values, not counting keys
+	uint32_t numbers;			//number of number values
+	uint32_t literals;			//number of true, false and null values
+	uint32_t max_depth;			//deepest nesting of objects and arrays
+} json_lint_stats_t;
+
+typedef struct {
+	const uint8_t *next;		//rest of the pointer after the reference token
+								//being looked up
+	const uint8_t *end;			//one past the last byte of the pointer
+	const uint8_t *token;		//reference token being looked up
+	const uint8_t *token_end;	//one past the last byte of the reference token
+	uint32_t depth;				//depth of the container searched or of the
+								//value found
+	uint8_t state;				//what the lookup is waiting for
+	bool object;				//the container searched is an object
+	size_t index;				//array index of the reference token
+	size_t count;				//values seen in the array searched
+	size_t offset;				//offset of the value found
+	size_t length;				//bytes of the value found, 0 if not found
+} json_lint_pointer_t;
+
+typedef struct {
+	uint64_t significand;		//first significant digits, as many as fit
+	int64_t scale;				//power of ten of the last digit of the
+								//significand, without the exponent
+	uint32_t exponent;			//value of the exponent digits, capped
+	uint32_t digits;			//digits of the significand
+	bool negative;				//starts with a minus sign
+	bool integer;				//has no fraction or exponent
+	bool exponent_negative;		//exponent starts with a minus sign
+	bool more;					//has nonzero digits past the significand
+	uint8_t number_class;		//json_lint_number_class_t of the last number
+} json_lint_number_t;
+
+typedef struct {
+	uint8_t *tables;			//stack of the key tables of the open objects
+	size_t tables_size;			//bytes allocated for the tables
+	size_t tables_used;			//bytes of the tables of the open objects
+	size_t table;				//offset of the table of the innermost object
+	uint8_t *keys;				//stack of the decoded keys of the open objects
+	size_t keys_size;			//bytes allocated for the keys
+	size_t keys_used;			//bytes of the keys of the open objects
+	size_t cut_length;			//bytes of a key cut by the end of a chunk, kept
+								//after the keys
+	size_t key_offset;			//offset of the open quote of the last key
+	bool cut;					//a key was cut by the end of a chunk
+} json_lint_arena_t;
+
+typedef struct {
+	uint32_t max_depth;			//option: deepest nesting allowed, at most
+								//JSON_LINT_DEPTH_MAX
+	uint32_t max_members;		//option: most members of an object or values
+								//of an array, 0 for no limit
+	size_t max_length;			//option: most bytes of text, 0 for no limit
+	size_t max_string;			//option: most bytes between the quotes of a
+								//string, 0 for no limit
+	size_t max_number;			//option: most bytes of a number, 0 for no limit
+	uint8_t dialect;			//option: json_lint_dialect_t of the text
+	json_lint_tape_t *tape;		//option: entries to record the values in, in
+								//the order of the text, NULL to not record
+	size_t tape_size;			//option: number of entries of the tape
+	size_t tape_count;			//number of entries recorded in the tape
+	size_t tape_open;			//tape index of the innermost open object or
+								//array
+	bool classify_numbers;		//option: find the json_lint_number_class_t of
+								//each number, given in the tape and number
+	json_lint_arena_t *key_arena;	//option: memory to check for duplicate
+								//keys in, NULL to not check
+	json_lint_pointer_t *pointer;	//JSON pointer being looked up by
+								//LintJSONPointer(), NULL once it is done
+	uint8_t *minify;			//option: buffer to write the text without its
+								//whitespace to, NULL to not write
+	size_t minify_size;			//option: bytes of the buffer, at least the
+								//length of the text
+	size_t minify_length;		//bytes written to the buffer
+	uint8_t *minify_span;		//first byte of the chunk not yet written
+	json_lint_diagnostic_t *errors;	//option: entries to record the errors in
+								//when recovering from them, NULL to stop at the
+								//first error
+	size_t errors_size;			//option: most errors to record
+	size_t error_count;			//number of errors recorded
+	uint8_t *ptr_invalid_json;	//pointer to invalid json, if the result is
+								//RESULT_JSON_LINT_INVALID
+	size_t offset_invalid_json;	//offset of invalid json from the start of text
+	json_lint_error_t error;	//reason the json is invalid
+	uint32_t depth;				//current nesting of objects and arrays
+	json_lint_stats_t stats;	//counts of the json text linted
+	uint8_t state;				//what the parser expects next
+	uint8_t token;				//part of the string, number or literal name
+								//the parser is inside of
+	uint8_t token_count;		//bytes of the token part matched so far
+	uint8_t comment;			//part of a comment the parser is inside of
+	size_t token_offset;		//offset of the first byte of the string or
+								//number the parser is inside of
+	json_lint_number_t number;	//value of the number the parser is inside of,
+								//when ctx->classify_numbers is set
+	bool final;					//true when no more text follows the chunk
+	size_t offset;				//offset of the chunk from the start of text
+	uint8_t *chunk;				//chunk of text being linted
+	uint64_t stack[(JSON_LINT_DEPTH_MAX + 63) / 64];	//1 bit per nesting
+								//level, 1=object 0=array
+	uint32_t members[JSON_LINT_DEPTH_MAX];	//members of each open object and
+								//array, counted when max_members is set
+} json_lint_context_t;
+
 /******************************************************************************
 * Variables
 ******************************************************************************/
-uint8_t *ptr_invalid_json;		//pointer to invalid json, if LintJSON() result
-								//is RESULT_JSON_LINT_INVALID
+extern uint8_t *ptr_invalid_json;	//pointer to invalid json, if LintJSON() result
+									//is RESULT_JSON_LINT_INVALID
 
 /******************************************************************************
 * Function Prototypes
 ******************************************************************************/
 json_lint_result_t LintJSON(uint8_t *ptr_text, bool disp_messages);
+json_lint_result_t LintJSONN(uint8_t *ptr_text, size_t length, bool disp_messages);
+void LintJSONInit(json_lint_context_t *ctx);
+json_lint_result_t LintJSONContext(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length);
+void LintJSONBegin(json_lint_context_t *ctx);
+json_lint_result_t LintJSONFeed(json_lint_context_t *ctx, uint8_t *chunk, size_t length);
+json_lint_result_t LintJSONFinish(json_lint_context_t *ctx);
+void LintJSONBeginMember(json_lint_context_t *ctx, size_t offset, uint32_t depth, const uint64_t *stack);
+void LintJSONAddStats(json_lint_stats_t *total, const json_lint_stats_t *stats);
+const char *LintJSONErrorString(json_lint_error_t error);
+void LintJSONArenaFree(json_lint_arena_t *arena);
+json_lint_result_t LintJSONPointer(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length,
+	const char *pointer, uint8_t **value, size_t *value_length);
+json_lint_result_t LintJSONMinify(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length,
+	uint8_t *output, size_t *output_length);
+void LintJSONLocate(const uint8_t *ptr_text, size_t offset, json_lint_location_t *location);
 
 #endif
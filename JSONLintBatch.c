@@ -0,0 +1,996 @@
+/******************************************************************************
+* File Name:  JSONLintBatch.c
+*
+* Description:
+* Implementation of batch linting of buffers and files on a worker pool, with
+* an io_uring or pread reader for the files.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The documents are cut into tasks of BATCH_TASK_SIZE in order.  A worker
+* keeps its context, key arena and read buffers from task to task, so a batch
+* allocates memory only for its workers and for files larger than any read
+* before.  With io_uring each worker has its own ring with a slot for each
+* file in flight: the open, read and close of each file are queued on the
+* ring, so one system call submits the requests of many files and waits for
+* the next one to finish, and a file is linted as soon as its read is done
+* while the others are still being read.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE			//O_CLOEXEC, AT_FDCWD, pread(), syscall() and MAP_POPULATE
+							//under -std=c11
+#endif
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "JSONLint.h"
+#include "JSONLintBatch.h"
+#include "JSONLintPool.h"
+
+#if defined(__linux__) && !defined(JSON_LINT_NO_IO_URING)
+#define BATCH_IO_URING
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define BATCH_TASK_SIZE			256			//documents per task
+#define BATCH_BUFFER_SIZE		(64 * 1024)	//bytes of a read buffer at first
+#define BATCH_READ_MAX			(1U << 30)	//most bytes asked of one read
+#define BATCH_QUEUE_DEPTH_MAX	1024		//most files in flight per thread
+
+#define BATCH_OP_OPEN			0			//ring request opening a file
+#define BATCH_OP_READ			1			//ring request reading a file
+#define BATCH_OP_CLOSE			2			//ring request closing a file
+
+#define BATCH_USER_DATA(slot, op)	(((uint64_t)(slot) << 2) | (op))
+#define BATCH_SLOT(data)		((uint32_t)((data) >> 2))
+#define BATCH_OP(data)			((uint32_t)(data) & 0x03)
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	uint8_t *buffer;			//text read so far
+	size_t capacity;			//bytes of buffer
+	size_t length;				//bytes read
+	size_t asked;				//bytes asked of the read in flight
+	size_t document;			//index of the file being read
+	int fd;						//descriptor of the file
+	bool busy;					//a file is being read into the slot
+} batch_slot_t;
+
+#if defined(BATCH_IO_URING)
+typedef struct {
+	int fd;						//descriptor of the ring, -1 if there is none
+	uint32_t entries;			//submission queue entries
+	uint32_t tail;				//submission queue tail, given to the kernel
+								//by RingSubmit()
+	uint32_t pending;			//requests queued but not submitted
+	uint32_t in_flight;			//requests queued but not completed
+	_Atomic uint32_t *sq_head;
+	_Atomic uint32_t *sq_tail;
+	uint32_t sq_mask;
+	uint32_t *sq_array;
+	struct io_uring_sqe *sqes;
+	_Atomic uint32_t *cq_head;
+	_Atomic uint32_t *cq_tail;
+	uint32_t cq_mask;
+	struct io_uring_cqe *cqes;
+	void *sq_ring;				//mapped submission queue, MAP_FAILED if not
+	size_t sq_ring_size;
+	void *cq_ring;				//mapped completion queue, MAP_FAILED if not or
+								//if it shares the submission queue's map
+	size_t cq_ring_size;
+	size_t sqes_size;
+} batch_ring_t;
+#endif
+
+typedef struct {
+	json_lint_context_t ctx;	//context the documents are linted with
+	json_lint_arena_t arena;	//memory for the keys of an object
+	json_lint_stats_t stats;	//counts of the json of the documents
+	batch_slot_t *slots;		//a slot for each file in flight, slot 0 is
+								//the buffer of the pread reader
+	uint32_t slot_count;
+#if defined(BATCH_IO_URING)
+	batch_ring_t ring;
+#endif
+} batch_worker_t;
+
+typedef struct {
+	json_lint_batch_t *batch;
+	uint8_t *const *texts;		//documents of LintJSONBatch(), or NULL
+	const size_t *lengths;
+	const char *const *paths;	//files of LintJSONBatchFiles(), or NULL
+	size_t count;				//number of documents
+	size_t limit;				//most bytes of a file to read
+	bool use_ring;				//read the files with io_uring
+	json_lint_batch_result_t *results;
+	batch_worker_t *workers;
+} batch_run_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static json_lint_result_t BatchRun(batch_run_t *run);
+static void BatchTask(void *arg, uint32_t task, uint32_t worker);
+static bool WorkerCreate(batch_run_t *run, batch_worker_t *worker);
+static void WorkerFree(batch_worker_t *worker);
+static void LintDocument(batch_run_t *run, batch_worker_t *worker, size_t document, uint8_t *text,
+	size_t length);
+static void SetUnread(batch_run_t *run, size_t document, int read_error);
+static bool Reserve(batch_slot_t *slot, size_t size);
+static void ReadFile(batch_run_t *run, batch_worker_t *worker, size_t document);
+#if defined(BATCH_IO_URING)
+static void ReadFilesRing(batch_run_t *run, batch_worker_t *worker, size_t first, size_t last);
+static void Complete(batch_run_t *run, batch_worker_t *worker, uint64_t data, int32_t res);
+static void QueueRead(batch_run_t *run, batch_worker_t *worker, uint32_t slot);
+static bool RingCreate(batch_ring_t *ring, uint32_t entries);
+static void RingFree(batch_ring_t *ring);
+static struct io_uring_sqe *RingQueue(batch_ring_t *ring, uint8_t opcode, int fd, uint64_t data);
+static bool RingSubmit(batch_ring_t *ring);
+static bool RingTake(batch_ring_t *ring, uint64_t *data, int32_t *res);
+#endif
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintJSONBatchInit
+*
+* Description:
+* Set the options of a batch lint to their defaults: one thread per
+* processor, JSON_LINT_BATCH_QUEUE_DEPTH files in flight per thread, io_uring
+* where it can be used, strict JSON and nesting up to JSON_LINT_DEPTH_MAX.
+*
+* Parameters:
+* batch		json_lint_batch_t *		options and results to initialize
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintJSONBatchInit(json_lint_batch_t *batch) {
+	memset(batch, 0, sizeof(json_lint_batch_t));
+	batch->dialect = DIALECT_JSON_LINT_ECMA404;
+	batch->max_depth = JSON_LINT_DEPTH_MAX;
+	batch->duplicate_keys = false;
+	batch->pread = false;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONBatch
+*
+* Description:
+* Lint each of an array of buffers as a JSON text of its own.
+*
+* Parameters:
+* batch		json_lint_batch_t *			options, set with LintJSONBatchInit(),
+*										and counts of the lint
+* texts		uint8_t *const *			pointer to the text of each document
+* lengths	const size_t *				number of bytes of each document
+* count		size_t						number of documents
+* results	json_lint_batch_result_t *	result of each document, count of them
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS if every document is valid,
+*						otherwise RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* A batch with no documents is valid.
+*
+******************************************************************************/
+json_lint_result_t LintJSONBatch(json_lint_batch_t *batch, uint8_t *const *texts, const size_t *lengths,
+	size_t count, json_lint_batch_result_t *results) {
+	batch_run_t run;
+
+	memset(&run, 0, sizeof(run));
+	run.batch = batch;
+	run.texts = texts;
+	run.lengths = lengths;
+	run.count = count;
+	run.results = results;
+
+	return BatchRun(&run);
+}
+
+/******************************************************************************
+* Function Name:  LintJSONBatchFiles
+*
+* Description:
+* Read and lint each of an array of files as a JSON text of its own.
+*
+* Parameters:
+* batch		json_lint_batch_t *			options, set with LintJSONBatchInit(),
+*										and counts of the lint
+* paths		const char *const *			path of each file
+* count		size_t						number of files
+* results	json_lint_batch_result_t *	result of each file, count of them
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS if every file is read and
+*						valid, otherwise RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* A file that can not be opened or read has its errno in read_error and
+* counts as unread, not invalid.  The files are read whole, or up to one byte
+* past max_length so that a longer file is reported as too large.
+*
+******************************************************************************/
+json_lint_result_t LintJSONBatchFiles(json_lint_batch_t *batch, const char *const *paths, size_t count,
+	json_lint_batch_result_t *results) {
+	batch_run_t run;
+
+	memset(&run, 0, sizeof(run));
+	run.batch = batch;
+	run.paths = paths;
+	run.count = count;
+	run.results = results;
+	run.limit = (batch->max_length != 0 && batch->max_length < SIZE_MAX) ? batch->max_length + 1 : SIZE_MAX;
+#if defined(BATCH_IO_URING)
+	run.use_ring = !batch->pread;
+#endif
+
+	return BatchRun(&run);
+}
+
+/******************************************************************************
+* Function Name:  BatchRun
+*
+* Description:
+* Lint the documents of a batch on the worker pool and count the results.
+*
+* Parameters:
+* run		batch_run_t *		documents and results of the batch
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS if every document is read and
+*						valid, otherwise RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* The workers are made before the pool starts, so a worker that can not have
+* a ring reads with pread.  If the first worker can not have one, io_uring is
+* taken to be unusable and no other worker tries.
+*
+******************************************************************************/
+static json_lint_result_t BatchRun(batch_run_t *run) {
+	json_lint_batch_t *batch = run->batch;
+	uint32_t task_count = (uint32_t)((run->count + BATCH_TASK_SIZE - 1) / BATCH_TASK_SIZE);
+	uint32_t worker_count = (batch->threads != 0) ? batch->threads : PoolWorkerCount();
+	uint32_t created = 0;
+	bool no_memory = false;
+
+	batch->valid = 0;
+	batch->invalid = 0;
+	batch->unread = 0;
+	batch->bytes = 0;
+	memset(&batch->stats, 0, sizeof(batch->stats));
+
+	if (worker_count > JSON_LINT_POOL_WORKERS_MAX) {
+		worker_count = JSON_LINT_POOL_WORKERS_MAX;
+	}
+	if (worker_count > task_count) {
+		worker_count = (task_count > 0) ? task_count : 1;
+	}
+	run->workers = calloc(worker_count, sizeof(batch_worker_t));
+	while (run->workers != NULL && created < worker_count && !no_memory) {
+		no_memory = !WorkerCreate(run, &run->workers[created]);
+		created++;
+	}
+	batch->reader = run->use_ring ? "io_uring" : "pread";
+
+	if (run->workers == NULL || no_memory) {
+		for (size_t document = 0; document < run->count; document++) {
+			SetUnread(run, document, ENOMEM);
+		}
+	} else {
+		PoolRun(worker_count, task_count, BatchTask, run);
+	}
+
+	for (uint32_t worker = 0; worker < created; worker++) {
+		LintJSONAddStats(&batch->stats, &run->workers[worker].stats);
+		WorkerFree(&run->workers[worker]);
+	}
+	free(run->workers);
+	for (size_t document = 0; document < run->count; document++) {
+		if (run->results[document].read_error != 0) {
+			batch->unread++;
+		} else if (run->results[document].result == RESULT_JSON_LINT_SUCCESS) {
+			batch->valid++;
+		} else {
+			batch->invalid++;
+		}
+		batch->bytes += run->results[document].length;
+	}
+
+	return (batch->valid == run->count) ? RESULT_JSON_LINT_SUCCESS : RESULT_JSON_LINT_INVALID;
+}
+
+/******************************************************************************
+* Function Name:  BatchTask
+*
+* Description:
+* Lint the documents of one task, reading them first if they are files.
+*
+* Parameters:
+* arg		void *		pointer to the batch_run_t of the batch
+* task		uint32_t	number of the task
+* worker	uint32_t	number of the worker running the task
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void BatchTask(void *arg, uint32_t task, uint32_t worker) {
+	batch_run_t *run = arg;
+	batch_worker_t *state = &run->workers[worker];
+	size_t first = (size_t)task * BATCH_TASK_SIZE;
+	size_t last = (run->count - first > BATCH_TASK_SIZE) ? first + BATCH_TASK_SIZE : run->count;
+
+	if (run->paths == NULL) {
+		for (size_t document = first; document < last; document++) {
+			LintDocument(run, state, document, run->texts[document], run->lengths[document]);
+		}
+#if defined(BATCH_IO_URING)
+	} else if (state->ring.fd >= 0) {
+		ReadFilesRing(run, state, first, last);
+#endif
+	} else {
+		for (size_t document = first; document < last; document++) {
+			ReadFile(run, state, document);
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  WorkerCreate
+*
+* Description:
+* Make the context and, for files, the read slots and ring of a worker.
+*
+* Parameters:
+* run		batch_run_t *		batch the worker lints
+* worker	batch_worker_t *	worker to make, all 0
+*
+* Return Value:
+* bool		false if the memory could not be allocated
+*
+* Notes:
+* The buffers of the slots are allocated when a file is first read into them.
+*
+******************************************************************************/
+static bool WorkerCreate(batch_run_t *run, batch_worker_t *worker) {
+	json_lint_batch_t *batch = run->batch;
+	uint32_t depth = (batch->queue_depth != 0) ? batch->queue_depth : JSON_LINT_BATCH_QUEUE_DEPTH;
+	bool created = true;
+
+	LintJSONInit(&worker->ctx);
+	worker->ctx.dialect = batch->dialect;
+	worker->ctx.max_depth = batch->max_depth;
+	worker->ctx.max_members = batch->max_members;
+	worker->ctx.max_length = batch->max_length;
+	worker->ctx.max_string = batch->max_string;
+	worker->ctx.max_number = batch->max_number;
+	if (batch->duplicate_keys) {
+		worker->ctx.key_arena = &worker->arena;
+	}
+#if defined(BATCH_IO_URING)
+	worker->ring.fd = -1;
+#endif
+
+	if (run->paths != NULL) {
+		if (depth > BATCH_QUEUE_DEPTH_MAX) {
+			depth = BATCH_QUEUE_DEPTH_MAX;
+		}
+#if defined(BATCH_IO_URING)
+		//a slot has one request in flight, and each of its files one close
+		if (run->use_ring && RingCreate(&worker->ring, 2 * depth)) {
+			worker->slot_count = depth;
+		} else if (worker == run->workers) {
+			run->use_ring = false;
+		}
+#endif
+		if (worker->slot_count == 0) {
+			worker->slot_count = 1;
+		}
+		worker->slots = calloc(worker->slot_count, sizeof(batch_slot_t));
+		created = (worker->slots != NULL);
+	}
+
+	return created;
+}
+
+/******************************************************************************
+* Function Name:  WorkerFree
+*
+* Description:
+* Release the memory, buffers and ring of a worker.
+*
+* Parameters:
+* worker	batch_worker_t *	worker made by WorkerCreate()
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void WorkerFree(batch_worker_t *worker) {
+	for (uint32_t slot = 0; worker->slots != NULL && slot < worker->slot_count; slot++) {
+		free(worker->slots[slot].buffer);
+	}
+	free(worker->slots);
+	LintJSONArenaFree(&worker->arena);
+#if defined(BATCH_IO_URING)
+	RingFree(&worker->ring);
+#endif
+}
+
+/******************************************************************************
+* Function Name:  LintDocument
+*
+* Description:
+* Lint one document and keep its result.
+*
+* Parameters:
+* run		batch_run_t *		batch the document belongs to
+* worker	batch_worker_t *	worker linting the document
+* document	size_t				index of the document
+* text		uint8_t *			text of the document
+* length	size_t				number of bytes of text
+*
+* Return Value:	None.
+*
+* Notes:
+* The line and column of an error are counted while the text is still at
+* hand, the buffer of a file is reused for the next one.
+*
+******************************************************************************/
+static void LintDocument(batch_run_t *run, batch_worker_t *worker, size_t document, uint8_t *text,
+	size_t length) {
+	json_lint_batch_result_t *result = &run->results[document];
+	json_lint_location_t location;
+
+	memset(result, 0, sizeof(json_lint_batch_result_t));
+	result->length = length;
+	result->result = LintJSONContext(&worker->ctx, text, length);
+	if (result->result != RESULT_JSON_LINT_SUCCESS) {
+		result->error = worker->ctx.error;
+		result->offset_invalid_json = worker->ctx.offset_invalid_json;
+		memset(&location, 0, sizeof(location));
+		LintJSONLocate(text, result->offset_invalid_json, &location);
+		result->line = location.line;
+		result->column = location.column;
+	}
+	LintJSONAddStats(&worker->stats, &worker->ctx.stats);
+}
+
+/******************************************************************************
+* Function Name:  SetUnread
+*
+* Description:
+* Keep the result of a file that could not be read.
+*
+* Parameters:
+* run			batch_run_t *	batch the file belongs to
+* document		size_t			index of the file
+* read_error	int				errno of the failure
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void SetUnread(batch_run_t *run, size_t document, int read_error) {
+	json_lint_batch_result_t *result = &run->results[document];
+
+	memset(result, 0, sizeof(json_lint_batch_result_t));
+	result->result = RESULT_JSON_LINT_INVALID;
+	result->read_error = read_error;
+}
+
+/******************************************************************************
+* Function Name:  Reserve
+*
+* Description:
+* Make the buffer of a slot hold at least a number of bytes.
+*
+* Parameters:
+* slot		batch_slot_t *		slot of the buffer
+* size		size_t				bytes needed
+*
+* Return Value:
+* bool		false if the memory could not be allocated
+*
+* Notes:
+* The buffer is never smaller than BATCH_BUFFER_SIZE and is not shrunk, so
+* it is allocated again only for a file larger than any before it.
+*
+******************************************************************************/
+static bool Reserve(batch_slot_t *slot, size_t size) {
+	uint8_t *buffer;
+	bool reserved = true;
+
+	if (size < BATCH_BUFFER_SIZE) {
+		size = BATCH_BUFFER_SIZE;
+	}
+	if (size > slot->capacity) {
+		buffer = realloc(slot->buffer, size);
+		if (buffer == NULL) {
+			reserved = false;
+		} else {
+			slot->buffer = buffer;
+			slot->capacity = size;
+		}
+	}
+
+	return reserved;
+}
+
+/******************************************************************************
+* Function Name:  ReadFile
+*
+* Description:
+* Read a file with pread into the worker's buffer and lint it.
+*
+* Parameters:
+* run		batch_run_t *		batch the file belongs to
+* worker	batch_worker_t *	worker reading the file
+* document	size_t				index of the file
+*
+* Return Value:	None.
+*
+* Notes:
+* As with the ring, a read that gives fewer bytes than asked is taken as the
+* end of the file, so a file smaller than the buffer costs an open, one pread
+* and a close.
+*
+******************************************************************************/
+static void ReadFile(batch_run_t *run, batch_worker_t *worker, size_t document) {
+	batch_slot_t *slot = &worker->slots[0];
+	size_t asked = 0;
+	ssize_t count = 0;
+	int read_error = 0;
+	int fd = open(run->paths[document], O_RDONLY | O_CLOEXEC);
+
+	slot->length = 0;
+	if (fd < 0) {
+		read_error = errno;
+	}
+	while (read_error == 0 && (size_t)count == asked && slot->length < run->limit) {
+		if (!Reserve(slot, (slot->length == slot->capacity) ? 2 * slot->capacity : slot->capacity)) {
+			read_error = ENOMEM;
+		} else {
+			asked = slot->capacity - slot->length;
+			if (asked > run->limit - slot->length) {
+				asked = run->limit - slot->length;
+			}
+			count = pread(fd, slot->buffer + slot->length, asked, (off_t)slot->length);
+			if (count > 0) {
+				slot->length += (size_t)count;
+			} else if (count < 0 && errno == EINTR) {
+				count = (ssize_t)asked;
+			} else if (count < 0) {
+				read_error = errno;
+			}
+		}
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+
+	if (read_error != 0) {
+		SetUnread(run, document, read_error);
+	} else {
+		LintDocument(run, worker, document, slot->buffer, slot->length);
+	}
+}
+
+#if defined(BATCH_IO_URING)
+/******************************************************************************
+* Function Name:  ReadFilesRing
+*
+* Description:
+* Read the files of a task with the worker's io_uring and lint each one as
+* its read finishes.
+*
+* Parameters:
+* run		batch_run_t *		batch the files belong to
+* worker	batch_worker_t *	worker reading the files
+* first		size_t				index of the first file of the task
+* last		size_t				one past the index of the last file
+*
+* Return Value:	None.
+*
+* Notes:
+* A file is opened when a slot is free and the ring has room for its
+* requests.  Every completion queues at most one request in place of the one
+* it ends, so the requests in flight never outnumber the ring's entries.  If
+* the ring fails the worker goes on with pread: the files it had in flight
+* are read again, and their descriptors are left open.
+*
+******************************************************************************/
+static void ReadFilesRing(batch_run_t *run, batch_worker_t *worker, size_t first, size_t last) {
+	batch_ring_t *ring = &worker->ring;
+	batch_slot_t *slot;
+	struct io_uring_sqe *sqe;
+	size_t next = first;
+	uint64_t data;
+	int32_t res;
+	bool failed = false;
+
+	while (!failed && (next < last || ring->in_flight > 0)) {
+		for (uint32_t index = 0; index < worker->slot_count && next < last && ring->in_flight < ring->entries;
+			index++) {
+			slot = &worker->slots[index];
+			if (!slot->busy) {
+				slot->busy = true;
+				slot->document = next++;
+				sqe = RingQueue(ring, IORING_OP_OPENAT, AT_FDCWD, BATCH_USER_DATA(index, BATCH_OP_OPEN));
+				sqe->addr = (uintptr_t)run->paths[slot->document];
+				sqe->open_flags = O_RDONLY | O_CLOEXEC;
+			}
+		}
+		failed = !RingSubmit(ring);
+		while (!failed && RingTake(ring, &data, &res)) {
+			Complete(run, worker, data, res);
+		}
+	}
+
+	if (failed) {
+		RingFree(ring);
+		for (uint32_t index = 0; index < worker->slot_count; index++) {
+			if (worker->slots[index].busy) {
+				worker->slots[index].busy = false;
+				ReadFile(run, worker, worker->slots[index].document);
+			}
+		}
+		for (; next < last; next++) {
+			ReadFile(run, worker, next);
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  Complete
+*
+* Description:
+* Go on with the file of a completed request: read it after it is opened,
+* read more or lint and close it after a read.
+*
+* Parameters:
+* run		batch_run_t *		batch the file belongs to
+* worker	batch_worker_t *	worker reading the file
+* data		uint64_t			slot and request, BATCH_USER_DATA()
+* res		int32_t				result of the request, -errno if it failed
+*
+* Return Value:	None.
+*
+* Notes:
+* A read that gives fewer bytes than asked is taken as the end of the file,
+* which holds for regular files, so a small file needs one read.  A read
+* that fills the buffer is followed by another into a buffer twice as large.
+*
+******************************************************************************/
+static void Complete(batch_run_t *run, batch_worker_t *worker, uint64_t data, int32_t res) {
+	batch_slot_t *slot = &worker->slots[BATCH_SLOT(data)];
+	batch_ring_t *ring = &worker->ring;
+	uint32_t op = BATCH_OP(data);
+
+	ring->in_flight--;
+	if (op == BATCH_OP_OPEN && res < 0) {
+		SetUnread(run, slot->document, -res);
+		slot->busy = false;
+	} else if (op == BATCH_OP_OPEN) {
+		slot->fd = res;
+		slot->length = 0;
+		QueueRead(run, worker, BATCH_SLOT(data));
+	} else if (op == BATCH_OP_READ && (res == -EINTR || res == -EAGAIN)) {
+		QueueRead(run, worker, BATCH_SLOT(data));
+	} else if (op == BATCH_OP_READ) {
+		if (res < 0) {
+			SetUnread(run, slot->document, -res);
+		} else {
+			slot->length += (size_t)res;
+		}
+		if (res >= 0 && (size_t)res == slot->asked && slot->length < run->limit) {
+			QueueRead(run, worker, BATCH_SLOT(data));
+		} else {
+			RingQueue(ring, IORING_OP_CLOSE, slot->fd, BATCH_USER_DATA(BATCH_SLOT(data), BATCH_OP_CLOSE));
+			slot->busy = false;
+			if (res >= 0) {
+				LintDocument(run, worker, slot->document, slot->buffer, slot->length);
+			}
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  QueueRead
+*
+* Description:
+* Queue a read of the rest of a slot's buffer from its file, making the
+* buffer larger if it is full.
+*
+* Parameters:
+* run		batch_run_t *		batch the file belongs to
+* worker	batch_worker_t *	worker reading the file
+* slot		uint32_t			number of the slot
+*
+* Return Value:	None.
+*
+* Notes:
+* If the buffer can not be made larger the file is unread with ENOMEM and is
+* closed instead.
+*
+******************************************************************************/
+static void QueueRead(batch_run_t *run, batch_worker_t *worker, uint32_t slot) {
+	batch_slot_t *read = &worker->slots[slot];
+	struct io_uring_sqe *sqe;
+	size_t asked;
+
+	if (!Reserve(read, (read->length == read->capacity) ? 2 * read->capacity : read->capacity)) {
+		SetUnread(run, read->document, ENOMEM);
+		RingQueue(&worker->ring, IORING_OP_CLOSE, read->fd, BATCH_USER_DATA(slot, BATCH_OP_CLOSE));
+		read->busy = false;
+	} else {
+		asked = read->capacity - read->length;
+		if (asked > run->limit - read->length) {
+			asked = run->limit - read->length;
+		}
+		read->asked = (asked < BATCH_READ_MAX) ? asked : BATCH_READ_MAX;
+		sqe = RingQueue(&worker->ring, IORING_OP_READ, read->fd, BATCH_USER_DATA(slot, BATCH_OP_READ));
+		sqe->addr = (uintptr_t)(read->buffer + read->length);
+		sqe->len = (uint32_t)read->asked;
+		sqe->off = read->length;
+	}
+}
+
+/******************************************************************************
+* Function Name:  RingCreate
+*
+* Description:
+* Set up an io_uring and map its queues.
+*
+* Parameters:
+* ring		batch_ring_t *		ring to set up
+* entries	uint32_t			submission queue entries
+*
+* Return Value:
+* bool		false if io_uring is not allowed or does not have the requests to
+*			open, read and close files (Linux 5.6)
+*
+* Notes:
+* ring->fd is -1 if the ring is not set up.  The kernel is asked which
+* requests it has, as io_uring_setup succeeds on kernels without them.
+*
+******************************************************************************/
+static bool RingCreate(batch_ring_t *ring, uint32_t entries) {
+	struct io_uring_params params;
+	struct io_uring_probe *probe;
+	size_t probe_size = sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+	uint8_t *sq;
+	uint8_t *cq;
+	bool created = false;
+
+	memset(ring, 0, sizeof(batch_ring_t));
+	memset(&params, 0, sizeof(params));
+	ring->sq_ring = MAP_FAILED;
+	ring->cq_ring = MAP_FAILED;
+	ring->sqes = MAP_FAILED;
+	ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	if (ring->fd >= 0) {
+		ring->entries = params.sq_entries;
+		ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+		if ((params.features & IORING_FEAT_SINGLE_MMAP) && ring->cq_ring_size > ring->sq_ring_size) {
+			ring->sq_ring_size = ring->cq_ring_size;
+		}
+		ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ring->fd, IORING_OFF_SQ_RING);
+		if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+			ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				ring->fd, IORING_OFF_CQ_RING);
+		}
+		ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ring->fd, IORING_OFF_SQES);
+		probe = calloc(1, probe_size);
+		created = (ring->sq_ring != MAP_FAILED && ring->sqes != MAP_FAILED && probe != NULL &&
+			((params.features & IORING_FEAT_SINGLE_MMAP) || ring->cq_ring != MAP_FAILED) &&
+			syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0 &&
+			probe->last_op >= IORING_OP_READ &&
+			(probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED) &&
+			(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+			(probe->ops[IORING_OP_CLOSE].flags & IO_URING_OP_SUPPORTED));
+		free(probe);
+	}
+
+	if (created) {
+		sq = ring->sq_ring;
+		cq = (ring->cq_ring != MAP_FAILED) ? ring->cq_ring : ring->sq_ring;
+		ring->sq_head = (_Atomic uint32_t *)(sq + params.sq_off.head);
+		ring->sq_tail = (_Atomic uint32_t *)(sq + params.sq_off.tail);
+		ring->sq_mask = *(uint32_t *)(sq + params.sq_off.ring_mask);
+		ring->sq_array = (uint32_t *)(sq + params.sq_off.array);
+		ring->cq_head = (_Atomic uint32_t *)(cq + params.cq_off.head);
+		ring->cq_tail = (_Atomic uint32_t *)(cq + params.cq_off.tail);
+		ring->cq_mask = *(uint32_t *)(cq + params.cq_off.ring_mask);
+		ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+		ring->tail = atomic_load_explicit(ring->sq_tail, memory_order_relaxed);
+	} else {
+		RingFree(ring);
+	}
+
+	return created;
+}
+
+/******************************************************************************
+* Function Name:  RingFree
+*
+* Description:
+* Unmap the queues of an io_uring and close it.
+*
+* Parameters:
+* ring		batch_ring_t *		ring set up, or partly set up, by RingCreate()
+*
+* Return Value:	None.
+*
+* Notes:
+* Requests still in flight are cancelled by the kernel.
+*
+******************************************************************************/
+static void RingFree(batch_ring_t *ring) {
+	if (ring->fd >= 0) {
+		if (ring->sqes != MAP_FAILED) {
+			munmap(ring->sqes, ring->sqes_size);
+		}
+		if (ring->cq_ring != MAP_FAILED) {
+			munmap(ring->cq_ring, ring->cq_ring_size);
+		}
+		if (ring->sq_ring != MAP_FAILED) {
+			munmap(ring->sq_ring, ring->sq_ring_size);
+		}
+		close(ring->fd);
+	}
+	ring->fd = -1;
+	ring->sq_ring = MAP_FAILED;
+	ring->cq_ring = MAP_FAILED;
+	ring->sqes = MAP_FAILED;
+}
+
+/******************************************************************************
+* Function Name:  RingQueue
+*
+* Description:
+* Take the next submission queue entry of an io_uring for a request.
+*
+* Parameters:
+* ring		batch_ring_t *		ring to queue the request on
+* opcode	uint8_t				IORING_OP_ of the request
+* fd		int					file descriptor of the request
+* data		uint64_t			slot and request, BATCH_USER_DATA()
+*
+* Return Value:
+* struct io_uring_sqe *		entry, the other fields 0 for the caller to set
+*
+* Notes:
+* The caller keeps the requests in flight below ring->entries, so there is
+* always a free entry.  The entry is given to the kernel by RingSubmit().
+*
+******************************************************************************/
+static struct io_uring_sqe *RingQueue(batch_ring_t *ring, uint8_t opcode, int fd, uint64_t data) {
+	uint32_t index = ring->tail & ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[index];
+
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->user_data = data;
+	ring->sq_array[index] = index;
+	ring->tail++;
+	ring->pending++;
+	ring->in_flight++;
+
+	return sqe;
+}
+
+/******************************************************************************
+* Function Name:  RingSubmit
+*
+* Description:
+* Give the queued requests to the kernel and wait for one to complete.
+*
+* Parameters:
+* ring		batch_ring_t *		ring to submit
+*
+* Return Value:
+* bool		false if io_uring_enter failed
+*
+* Notes:
+* It does not wait when nothing is in flight, and returns at once if a
+* completion is already waiting to be taken.
+*
+******************************************************************************/
+static bool RingSubmit(batch_ring_t *ring) {
+	long submitted;
+
+	atomic_store_explicit(ring->sq_tail, ring->tail, memory_order_release);
+	do {
+		submitted = syscall(__NR_io_uring_enter, ring->fd, ring->pending, (ring->in_flight > 0) ? 1 : 0,
+			IORING_ENTER_GETEVENTS, NULL, 0);
+	} while (submitted < 0 && errno == EINTR);
+	if (submitted > 0) {
+		ring->pending -= (uint32_t)submitted;
+	}
+
+	return (submitted >= 0);
+}
+
+/******************************************************************************
+* Function Name:  RingTake
+*
+* Description:
+* Take the next completion of an io_uring.
+*
+* Parameters:
+* ring		batch_ring_t *		ring to take from
+* data		uint64_t *			slot and request of the completion
+* res		int32_t *			result of the request
+*
+* Return Value:
+* bool		false if there is no completion waiting
+*
+* Notes:	None.
+*
+******************************************************************************/
+static bool RingTake(batch_ring_t *ring, uint64_t *data, int32_t *res) {
+	uint32_t head = atomic_load_explicit(ring->cq_head, memory_order_relaxed);
+	bool taken = (head != atomic_load_explicit(ring->cq_tail, memory_order_acquire));
+
+	if (taken) {
+		*data = ring->cqes[head & ring->cq_mask].user_data;
+		*res = ring->cqes[head & ring->cq_mask].res;
+		atomic_store_explicit(ring->cq_head, head + 1, memory_order_release);
+	}
+
+	return taken;
+}
+#endif
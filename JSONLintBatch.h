@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name:  JSONLintBatch.h
+*
+* Description:
+* Lints many small JSON documents, given as buffers or as paths of files, on
+* several threads and gives the result of each one.  Files are read with
+* io_uring on Linux, so the reads of a thread are in flight while it lints
+* the files already read, or with pread where io_uring can not be used.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Reading files needs POSIX.  The pread reader is used if the program is built
+* with JSON_LINT_NO_IO_URING, or if the kernel does not allow io_uring.
+*
+******************************************************************************/
+#ifndef JSON_LINT_BATCH_H_
+#define JSON_LINT_BATCH_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "JSONLint.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define JSON_LINT_BATCH_QUEUE_DEPTH		32	//reads in flight per thread by default
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	json_lint_result_t result;	//RESULT_JSON_LINT_SUCCESS if the document was
+								//read and is valid
+	json_lint_error_t error;	//reason the document is invalid
+	size_t offset_invalid_json;	//offset of invalid json from the start of the
+								//document
+	size_t line;				//line of the invalid json, from 1, 0 if valid
+	size_t column;				//byte of the invalid json in its line, from 1
+	size_t length;				//bytes of the document
+	int read_error;				//errno if the file could not be read, else 0
+} json_lint_batch_result_t;
+
+typedef struct {
+	uint32_t threads;			//option: threads to lint on, 0 for one per
+								//processor
+	uint32_t queue_depth;		//option: files read at once by each thread,
+								//0 for JSON_LINT_BATCH_QUEUE_DEPTH
+	bool pread;					//option: read files with pread, not io_uring
+	uint8_t dialect;			//option: json_lint_dialect_t of the documents
+	uint32_t max_depth;			//option: deepest nesting allowed
+	bool duplicate_keys;		//option: report an object with a key twice
+	uint32_t max_members;		//option: most members of an object or values
+								//of an array, 0 for no limit
+	size_t max_length;			//option: most bytes of a document, 0 for no
+								//limit, a longer file is only read this far
+	size_t max_string;			//option: most bytes of a string, 0 for no limit
+	size_t max_number;			//option: most bytes of a number, 0 for no limit
+	const char *reader;			//"io_uring" or "pread", how the files of the
+								//last LintJSONBatchFiles() were read
+	size_t valid;				//number of valid documents
+	size_t invalid;				//number of invalid documents
+	size_t unread;				//number of files that could not be read
+	size_t bytes;				//bytes of all documents
+	json_lint_stats_t stats;	//counts of the json of all documents
+} json_lint_batch_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void LintJSONBatchInit(json_lint_batch_t *batch);
+json_lint_result_t LintJSONBatch(json_lint_batch_t *batch, uint8_t *const *texts, const size_t *lengths,
+	size_t count, json_lint_batch_result_t *results);
+json_lint_result_t LintJSONBatchFiles(json_lint_batch_t *batch, const char *const *paths, size_t count,
+	json_lint_batch_result_t *results);
+
+#endif
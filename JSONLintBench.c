@@ -0,0 +1,707 @@
+/******************************************************************************
+* File Name:  JSONLintBench.c
+*
+* Description:
+* Benchmark of the JSON lint.  Corpora of the shapes of text seen in use are
+* generated, each is linted a number of times after a warmup, and the
+* throughput is printed in MB/s and documents per second.  Build as:
+*		cc -O2 -mavx2 -pthread -o json_lint_bench JSONLintBench.c JSONLint.c
+*			JSONLintScan.c JSONLintNDJSON.c JSONLintPool.c
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The corpora are generated from a fixed seed, so every build lints the same
+* bytes.  Results are printed one JSON object per line, which can be saved
+* and given back with --baseline to fail the run when a corpus got slower.
+*
+* The corpora are:
+*		twitter		API responses of status objects with nested users, escapes
+*					and UTF-8 text, a few KB each
+*		canada		one GeoJSON feature collection of coordinate arrays, mostly
+*					numbers
+*		strings		arrays of long strings with many escapes
+*		deep		objects and arrays nested hundreds of levels
+*		ndjson		log records, one per line, linted with LintNDJSON()
+*		literals	arrays and small objects of true, false, null, short
+*					numbers and strings, and empty containers, to time the
+*					dispatch of values rather than the scanning of runs
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE		200809L	//clock_gettime() under -std=c11
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include "JSONLint.h"
+#include "JSONLintNDJSON.h"
+#include "JSONLintScan.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define BENCH_SIZE_DEFAULT		8		//MB of text per corpus
+#define BENCH_WARMUP_DEFAULT		3		//runs before timing
+#define BENCH_REPS_DEFAULT		20		//timed runs
+#define BENCH_THRESHOLD_DEFAULT		5.0		//percent slower that fails --baseline
+#define BENCH_SEED			0x9E3779B97F4A7C15ULL
+
+#define BENCH_DEEP_LEVELS		400		//nesting of the deep corpus
+#define BENCH_STRING_LENGTH		4096		//bytes of each long string
+#define BENCH_SMALL_VALUES		256		//values in each literals document
+#define BENCH_LINE_MAX			512		//longest line read from a baseline
+
+#define BENCH_EXIT_PASS			0
+#define BENCH_EXIT_REGRESSION		1
+#define BENCH_EXIT_ERROR		2
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	uint8_t *text;				//documents one after another
+	size_t length;				//bytes of text
+	size_t capacity;			//bytes allocated for text
+	size_t *starts;				//offset of each document
+	size_t doc_count;			//number of documents
+	size_t doc_capacity;		//documents allocated for starts
+	uint64_t random;			//state of the generator
+} bench_corpus_t;
+
+typedef struct {
+	const char *name;
+	void (*generate)(bench_corpus_t *corpus, size_t size);
+	bool ndjson;				//whole text is linted as NDJSON
+} bench_generator_t;
+
+typedef struct {
+	double best;				//fastest run, seconds
+	double median;				//middle run, seconds
+	size_t docs;				//documents, or NDJSON records, per run
+} bench_result_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void GenerateTwitter(bench_corpus_t *corpus, size_t size);
+static void GenerateCanada(bench_corpus_t *corpus, size_t size);
+static void GenerateStrings(bench_corpus_t *corpus, size_t size);
+static void GenerateDeep(bench_corpus_t *corpus, size_t size);
+static void GenerateNDJSON(bench_corpus_t *corpus, size_t size);
+static void GenerateLiterals(bench_corpus_t *corpus, size_t size);
+static void Append(bench_corpus_t *corpus, const char *format, ...);
+static void StartDocument(bench_corpus_t *corpus);
+static uint32_t Random(bench_corpus_t *corpus, uint32_t range);
+static bool RunCorpus(const bench_generator_t *generator, bench_corpus_t *corpus,
+	uint32_t warmup, uint32_t reps, bench_result_t *result);
+static bool LintCorpus(const bench_generator_t *generator, bench_corpus_t *corpus, size_t *docs);
+static int CompareTimes(const void *a, const void *b);
+static double FindBaseline(const char *path, const char *name);
+static double Now(void);
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+static const bench_generator_t generators[] = {
+	{ "twitter", GenerateTwitter, false },
+	{ "canada", GenerateCanada, false },
+	{ "strings", GenerateStrings, false },
+	{ "deep", GenerateDeep, false },
+	{ "ndjson", GenerateNDJSON, true },
+	{ "literals", GenerateLiterals, false },
+};
+
+static const char *const words[] = { "lorem", "ipsum", "caf\xC3\xA9", "na\xC3\xAFve",
+	"\xE2\x9C\x93", "json", "lint", "stream", "\xF0\x9F\x98\x80", "data" };
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  main
+*
+* Description:
+* Generate and lint each corpus and print the results.
+*
+* Parameters:
+* argc		int			number of arguments
+* argv		char **		options: --size MB, --warmup N, --reps N, --corpus name,
+*						--text, --baseline file, --threshold percent
+*
+* Return Value:
+* int		BENCH_EXIT_PASS, BENCH_EXIT_REGRESSION if a corpus is slower than
+*			the baseline by more than the threshold, or BENCH_EXIT_ERROR
+*
+* Notes:	None.
+*
+******************************************************************************/
+int main(int argc, char **argv) {
+	int status = BENCH_EXIT_PASS;
+	size_t size = BENCH_SIZE_DEFAULT;
+	uint32_t warmup = BENCH_WARMUP_DEFAULT;
+	uint32_t reps = BENCH_REPS_DEFAULT;
+	const char *only = NULL;
+	const char *baseline = NULL;
+	double threshold = BENCH_THRESHOLD_DEFAULT;
+	bool text = false;
+	bench_corpus_t corpus;
+	bench_result_t result;
+	double rate;
+	double baseline_rate;
+
+	for (int arg = 1; arg < argc && status == BENCH_EXIT_PASS; arg++) {
+		if (strcmp(argv[arg], "--text") == 0) {
+			text = true;
+		} else if (arg + 1 >= argc) {
+			status = BENCH_EXIT_ERROR;
+		} else if (strcmp(argv[arg], "--size") == 0) {
+			size = strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--warmup") == 0) {
+			warmup = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--reps") == 0) {
+			reps = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--corpus") == 0) {
+			only = argv[++arg];
+		} else if (strcmp(argv[arg], "--baseline") == 0) {
+			baseline = argv[++arg];
+		} else if (strcmp(argv[arg], "--threshold") == 0) {
+			threshold = strtod(argv[++arg], NULL);
+		} else {
+			status = BENCH_EXIT_ERROR;
+		}
+	}
+	if (status != BENCH_EXIT_PASS || size == 0 || reps == 0) {
+		fprintf(stderr, "usage: %s [--size MB] [--warmup N] [--reps N] [--corpus name] [--text]\n"
+			"\t[--baseline results.jsonl] [--threshold percent]\n", argv[0]);
+		status = BENCH_EXIT_ERROR;
+	}
+
+	for (size_t index = 0; status != BENCH_EXIT_ERROR && index < sizeof(generators) / sizeof(generators[0]); index++) {
+		if (only != NULL && strcmp(only, generators[index].name) != 0) {
+			continue;
+		}
+		memset(&corpus, 0, sizeof(corpus));
+		corpus.random = BENCH_SEED;
+		generators[index].generate(&corpus, size * 1024 * 1024);
+		if (!RunCorpus(&generators[index], &corpus, warmup, reps, &result)) {
+			fprintf(stderr, "%s: corpus is not valid JSON\n", generators[index].name);
+			status = BENCH_EXIT_ERROR;
+		} else {
+			rate = (double)corpus.length / result.median / 1e6;
+			if (text) {
+				printf("%-8s %10zu bytes %7zu docs  median %9.3f ms  best %9.3f ms  %8.1f MB/s  %10.0f docs/s\n",
+					generators[index].name, corpus.length, result.docs, result.median * 1e3,
+					result.best * 1e3, rate, (double)result.docs / result.median);
+			} else {
+				printf("{\"corpus\":\"%s\",\"kernel\":\"%s\",\"bytes\":%zu,\"docs\":%zu,\"warmup\":%u,"
+					"\"reps\":%u,\"best_ms\":%.3f,\"median_ms\":%.3f,\"mb_s\":%.1f,\"docs_s\":%.0f}\n",
+					generators[index].name, ScanKernel(), corpus.length, result.docs, warmup, reps,
+					result.best * 1e3, result.median * 1e3, rate, (double)result.docs / result.median);
+			}
+			fflush(stdout);
+			baseline_rate = (baseline != NULL) ? FindBaseline(baseline, generators[index].name) : 0;
+			if (baseline_rate > 0 && rate < baseline_rate * (1 - threshold / 100)) {
+				fprintf(stderr, "regression: %s %.1f MB/s, baseline %.1f MB/s (%.1f%%)\n",
+					generators[index].name, rate, baseline_rate, (rate / baseline_rate - 1) * 100);
+				status = BENCH_EXIT_REGRESSION;
+			}
+		}
+		free(corpus.text);
+		free(corpus.starts);
+	}
+
+	return status;
+}
+
+/******************************************************************************
+* Function Name:  GenerateTwitter
+*
+* Description:
+* Generate API responses holding a few status objects each.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void GenerateTwitter(bench_corpus_t *corpus, size_t size) {
+	uint32_t statuses;
+
+	while (corpus->length < size) {
+		StartDocument(corpus);
+		Append(corpus, "{\"statuses\":[");
+		statuses = 2 + Random(corpus, 4);
+		for (uint32_t status = 0; status < statuses; status++) {
+			Append(corpus, "%s{\"created_at\":\"Sun Aug 31 00:29:%02u +0000 2014\",\"id\":%llu,"
+				"\"id_str\":\"%llu\",\"text\":\"@user%u ", (status > 0) ? "," : "", Random(corpus, 60),
+				505874924095815681ULL + Random(corpus, 1000000), 505874924095815681ULL + status, Random(corpus, 1000));
+			for (uint32_t word = Random(corpus, 12) + 4; word > 0; word--) {
+				Append(corpus, "%s ", words[Random(corpus, sizeof(words) / sizeof(words[0]))]);
+			}
+			Append(corpus, "\\u3053\\u3093 \\\"quoted\\\"\\n#tag%u http:\\/\\/t.co\\/%u\",\"truncated\":false,"
+				"\"in_reply_to_status_id\":null,\"user\":{\"id\":%u,\"name\":\"User %u\",\"screen_name\":\"user%u\","
+				"\"location\":\"\",\"description\":\"%s %s\",\"followers_count\":%u,\"friends_count\":%u,"
+				"\"verified\":%s,\"profile_background_color\":\"C0DEED\",\"default_profile\":true},"
+				"\"entities\":{\"hashtags\":[{\"text\":\"tag%u\",\"indices\":[%u,%u]}],\"urls\":[],"
+				"\"user_mentions\":[{\"screen_name\":\"user%u\",\"id\":%u,\"indices\":[0,9]}]},"
+				"\"retweet_count\":%u,\"favorite_count\":%u,\"favorited\":false,\"retweeted\":false,"
+				"\"possibly_sensitive\":false,\"lang\":\"ja\",\"geo\":null,\"coordinates\":null,"
+				"\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"ja\"}}",
+				Random(corpus, 100), Random(corpus, 100000), Random(corpus, 1u << 30), Random(corpus, 1000),
+				Random(corpus, 1000), words[Random(corpus, 10)], words[Random(corpus, 10)], Random(corpus, 100000),
+				Random(corpus, 1000), Random(corpus, 2) ? "true" : "false", Random(corpus, 100),
+				Random(corpus, 50), 50 + Random(corpus, 50), Random(corpus, 1000), Random(corpus, 1u << 30),
+				Random(corpus, 500), Random(corpus, 500));
+		}
+		Append(corpus, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,"
+			"\"count\":%u,\"next_results\":\"?max_id=505874847260352512&q=%%E4%%B8%%80&count=100\"}}", statuses);
+	}
+}
+
+/******************************************************************************
+* Function Name:  GenerateCanada
+*
+* Description:
+* Generate one GeoJSON feature collection of polygons, mostly numbers with
+* many digits.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void GenerateCanada(bench_corpus_t *corpus, size_t size) {
+	uint32_t points;
+
+	StartDocument(corpus);
+	Append(corpus, "{\"type\":\"FeatureCollection\",\"features\":[");
+	for (uint32_t feature = 0; corpus->length < size; feature++) {
+		Append(corpus, "%s{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+			"\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[[", (feature > 0) ? "," : "");
+		points = 100 + Random(corpus, 1000);
+		for (uint32_t point = 0; point < points; point++) {
+			Append(corpus, "%s[-%u.%015u,%u.%015u]", (point > 0) ? "," : "", 52 + Random(corpus, 90),
+				Random(corpus, 1000000000), 41 + Random(corpus, 40), Random(corpus, 1000000000));
+		}
+		Append(corpus, "]]}}");
+	}
+	Append(corpus, "]}");
+}
+
+/******************************************************************************
+* Function Name:  GenerateStrings
+*
+* Description:
+* Generate arrays of long strings with escapes every few words.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void GenerateStrings(bench_corpus_t *corpus, size_t size) {
+	static const char *const escapes[] = { "\\n", "\\t", "\\\"", "\\\\", "\\/", "\\u00e9", "\\uD83D\\uDE00" };
+	size_t string_end;
+
+	while (corpus->length < size) {
+		StartDocument(corpus);
+		Append(corpus, "[");
+		for (uint32_t string = 0; string < 16; string++) {
+			Append(corpus, "%s\"", (string > 0) ? ",\n" : "");
+			string_end = corpus->length + BENCH_STRING_LENGTH;
+			while (corpus->length < string_end) {
+				Append(corpus, "%s %s ", words[Random(corpus, sizeof(words) / sizeof(words[0]))],
+					escapes[Random(corpus, sizeof(escapes) / sizeof(escapes[0]))]);
+			}
+			Append(corpus, "\"");
+		}
+		Append(corpus, "]");
+	}
+}
+
+/******************************************************************************
+* Function Name:  GenerateDeep
+*
+* Description:
+* Generate documents of objects and arrays nested BENCH_DEEP_LEVELS deep.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void GenerateDeep(bench_corpus_t *corpus, size_t size) {
+	while (corpus->length < size) {
+		StartDocument(corpus);
+		for (uint32_t level = 0; level < BENCH_DEEP_LEVELS; level++) {
+			Append(corpus, (level % 2 == 0) ? "{\"level%u\":" : "[%u,", level);
+		}
+		Append(corpus, "null");
+		for (uint32_t level = BENCH_DEEP_LEVELS; level > 0; level--) {
+			Append(corpus, ((level - 1) % 2 == 0) ? "}" : "]");
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  GenerateNDJSON
+*
+* Description:
+* Generate log records, one JSON object per line.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:
+* The whole text is one document, the records are counted by LintNDJSON().
+*
+******************************************************************************/
+static void GenerateNDJSON(bench_corpus_t *corpus, size_t size) {
+	static const char *const levels[] = { "debug", "info", "info", "info", "warn", "error" };
+
+	StartDocument(corpus);
+	while (corpus->length < size) {
+		Append(corpus, "{\"ts\":\"2024-03-%02uT%02u:%02u:%02u.%03uZ\",\"level\":\"%s\",\"msg\":\"request %s %s\","
+			"\"req\":{\"id\":\"%08x-%04x\",\"method\":\"GET\",\"path\":\"/api/v1/items/%u\",\"ms\":%u.%u,"
+			"\"status\":%u},\"tags\":[\"%s\",\"%s\"],\"retry\":%s}\n",
+			1 + Random(corpus, 28), Random(corpus, 24), Random(corpus, 60), Random(corpus, 60), Random(corpus, 1000),
+			levels[Random(corpus, 6)], words[Random(corpus, 10)], words[Random(corpus, 10)], Random(corpus, 1u << 31),
+			Random(corpus, 1u << 16), Random(corpus, 100000), Random(corpus, 2000), Random(corpus, 10),
+			200 + Random(corpus, 300), words[Random(corpus, 10)], words[Random(corpus, 10)],
+			Random(corpus, 4) ? "false" : "null");
+	}
+}
+
+/******************************************************************************
+* Function Name:  GenerateLiterals
+*
+* Description:
+* Generate documents of many small values: literal names, short numbers and
+* strings, empty containers and small objects.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to generate into
+* size		size_t				bytes of text to generate, at least
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void GenerateLiterals(bench_corpus_t *corpus, size_t size) {
+	static const char *const values[] = { "true", "false", "null", "0", "1", "-7", "42", "\"\"", "\"a\"",
+		"[]", "{}", "[true,false]", "{\"k\":null}", "[null,0,\"x\"]" };
+
+	while (corpus->length < size) {
+		StartDocument(corpus);
+		Append(corpus, "[");
+		for (uint32_t value = 0; value < BENCH_SMALL_VALUES; value++) {
+			Append(corpus, "%s%s", (value > 0) ? "," : "", values[Random(corpus, sizeof(values) / sizeof(values[0]))]);
+		}
+		Append(corpus, "]");
+	}
+}
+
+/******************************************************************************
+* Function Name:  Append
+*
+* Description:
+* Append formatted text to the corpus, growing it as needed.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus to append to
+* format	const char *		printf format of the text
+* ...							values of the format
+*
+* Return Value:	None.
+*
+* Notes:
+* The program exits if memory can not be allocated.
+*
+******************************************************************************/
+static void Append(bench_corpus_t *corpus, const char *format, ...) {
+	va_list args;
+	int length;
+
+	va_start(args, format);
+	length = vsnprintf(NULL, 0, format, args);
+	va_end(args);
+	if (corpus->length + (size_t)length + 1 > corpus->capacity) {
+		corpus->capacity = (corpus->capacity + (size_t)length + 1) * 2;
+		corpus->text = realloc(corpus->text, corpus->capacity);
+		if (corpus->text == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(BENCH_EXIT_ERROR);
+		}
+	}
+	va_start(args, format);
+	vsnprintf((char *)corpus->text + corpus->length, (size_t)length + 1, format, args);
+	va_end(args);
+	corpus->length += (size_t)length;
+}
+
+/******************************************************************************
+* Function Name:  StartDocument
+*
+* Description:
+* Mark the end of the text as the start of the next document.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus the document is in
+*
+* Return Value:	None.
+*
+* Notes:
+* The program exits if memory can not be allocated.
+*
+******************************************************************************/
+static void StartDocument(bench_corpus_t *corpus) {
+	if (corpus->doc_count == corpus->doc_capacity) {
+		corpus->doc_capacity = (corpus->doc_capacity == 0) ? 1024 : corpus->doc_capacity * 2;
+		corpus->starts = realloc(corpus->starts, corpus->doc_capacity * sizeof(size_t));
+		if (corpus->starts == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(BENCH_EXIT_ERROR);
+		}
+	}
+	corpus->starts[corpus->doc_count++] = corpus->length;
+}
+
+/******************************************************************************
+* Function Name:  Random
+*
+* Description:
+* Give the next number of the corpus generator, a xorshift generator so the
+* corpora are the same on every platform.
+*
+* Parameters:
+* corpus	bench_corpus_t *	corpus being generated
+* range		uint32_t			number of values, 1 or more
+*
+* Return Value:
+* uint32_t		number from 0 to range - 1
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint32_t Random(bench_corpus_t *corpus, uint32_t range) {
+	corpus->random ^= corpus->random << 13;
+	corpus->random ^= corpus->random >> 7;
+	corpus->random ^= corpus->random << 17;
+	return (uint32_t)((corpus->random >> 32) % range);
+}
+
+/******************************************************************************
+* Function Name:  RunCorpus
+*
+* Description:
+* Lint a corpus warmup times, then reps times with each run timed.
+*
+* Parameters:
+* generator		const bench_generator_t *	generator of the corpus
+* corpus		bench_corpus_t *			corpus to lint
+* warmup		uint32_t					runs before timing
+* reps			uint32_t					timed runs, 1 or more
+* result		bench_result_t *			times of the runs
+*
+* Return Value:
+* bool		false if a document of the corpus is not valid
+*
+* Notes:	None.
+*
+******************************************************************************/
+static bool RunCorpus(const bench_generator_t *generator, bench_corpus_t *corpus,
+	uint32_t warmup, uint32_t reps, bench_result_t *result) {
+	double *times = malloc(reps * sizeof(double));
+	bool valid = (times != NULL) && LintCorpus(generator, corpus, &result->docs);
+	double start;
+
+	for (uint32_t run = 0; valid && run < warmup; run++) {
+		valid = LintCorpus(generator, corpus, &result->docs);
+	}
+	for (uint32_t run = 0; valid && run < reps; run++) {
+		start = Now();
+		valid = LintCorpus(generator, corpus, &result->docs);
+		times[run] = Now() - start;
+	}
+	if (valid) {
+		qsort(times, reps, sizeof(double), CompareTimes);
+		result->best = times[0];
+		result->median = times[reps / 2];
+	}
+	free(times);
+
+	return valid;
+}
+
+/******************************************************************************
+* Function Name:  LintCorpus
+*
+* Description:
+* Lint each document of a corpus once.
+*
+* Parameters:
+* generator		const bench_generator_t *	generator of the corpus
+* corpus		bench_corpus_t *			corpus to lint
+* docs			size_t *					documents, or NDJSON records, linted
+*
+* Return Value:
+* bool		true if every document is valid
+*
+* Notes:	None.
+*
+******************************************************************************/
+static bool LintCorpus(const bench_generator_t *generator, bench_corpus_t *corpus, size_t *docs) {
+	json_lint_ndjson_t ndjson;
+	bool valid = true;
+	size_t end;
+
+	if (generator->ndjson) {
+		LintNDJSONInit(&ndjson);
+		ndjson.threads = 1;
+		valid = (LintNDJSON(&ndjson, corpus->text, corpus->length) == RESULT_JSON_LINT_SUCCESS);
+		*docs = ndjson.records;
+		LintNDJSONFree(&ndjson);
+	} else {
+		for (size_t doc = 0; doc < corpus->doc_count; doc++) {
+			end = (doc + 1 < corpus->doc_count) ? corpus->starts[doc + 1] : corpus->length;
+			if (LintJSONN(corpus->text + corpus->starts[doc], end - corpus->starts[doc], false) != RESULT_JSON_LINT_SUCCESS) {
+				valid = false;
+			}
+		}
+		*docs = corpus->doc_count;
+	}
+
+	return valid;
+}
+
+/******************************************************************************
+* Function Name:  CompareTimes
+*
+* Description:
+* Order two run times for qsort().
+*
+* Parameters:
+* a		const void *	pointer to the first time
+* b		const void *	pointer to the second time
+*
+* Return Value:
+* int		less than, equal to or greater than 0 as a is less than, equal to
+*			or greater than b
+*
+* Notes:	None.
+*
+******************************************************************************/
+static int CompareTimes(const void *a, const void *b) {
+	double first = *(const double *)a;
+	double second = *(const double *)b;
+
+	return (first > second) - (first < second);
+}
+
+/******************************************************************************
+* Function Name:  FindBaseline
+*
+* Description:
+* Find the MB/s of a corpus in results saved from an earlier run.
+*
+* Parameters:
+* path		const char *	file of results, one JSON object per line
+* name		const char *	name of the corpus
+*
+* Return Value:
+* double		MB/s of the corpus, or 0 if it is not in the file
+*
+* Notes:
+* Only lines printed by this program are understood.
+*
+******************************************************************************/
+static double FindBaseline(const char *path, const char *name) {
+	FILE *file = fopen(path, "r");
+	char line[BENCH_LINE_MAX];
+	char key[BENCH_LINE_MAX];
+	char *rate;
+	double baseline = 0;
+
+	snprintf(key, sizeof(key), "{\"corpus\":\"%s\",", name);
+	while (file != NULL && baseline == 0 && fgets(line, sizeof(line), file) != NULL) {
+		if (strncmp(line, key, strlen(key)) == 0 && (rate = strstr(line, "\"mb_s\":")) != NULL) {
+			baseline = strtod(rate + strlen("\"mb_s\":"), NULL);
+		}
+	}
+	if (file != NULL) {
+		fclose(file);
+	}
+
+	return baseline;
+}
+
+/******************************************************************************
+* Function Name:  Now
+*
+* Description:
+* Read a clock that only moves forward.
+*
+* Parameters:	None.
+*
+* Return Value:
+* double		time in seconds
+*
+* Notes:	None.
+*
+******************************************************************************/
+static double Now(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
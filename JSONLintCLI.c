@@ -0,0 +1,668 @@
+/******************************************************************************
+* File Name:  JSONLintCLI.c
+*
+* Description:
+* Command line tool that lints JSON files or standard input and prints the
+* file, line and column of each error.  Build as:
+*		cc -O2 -pthread -o json_lint JSONLintCLI.c JSONLint.c
+*			JSONLintScan.c JSONLintNDJSON.c JSONLintParallel.c JSONLintPool.c
+*			JSONLintBatch.c JSONLintProfile.c
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Regular files are memory mapped and linted in place, other inputs such as
+* pipes are read into memory first.  With --batch the files are read and
+* linted together by the batch lint instead, which reads many small files
+* with fewer system calls.  The exit status is 0 when every input is
+* valid, 1 when an input is invalid and 2 when an input can not be read or
+* the command line is wrong.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE			//madvise(), MADV_SEQUENTIAL and clock_gettime()
+							//under -std=c11
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "JSONLint.h"
+#include "JSONLintNDJSON.h"
+#include "JSONLintParallel.h"
+#include "JSONLintBatch.h"
+#include "JSONLintProfile.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define CHAR_LINEFEED			0x0A
+
+#define CLI_EXIT_VALID			0	//every input is valid
+#define CLI_EXIT_INVALID		1	//an input is invalid
+#define CLI_EXIT_ERROR			2	//an input can not be read, or bad usage
+
+#define CLI_STDIN_PATH			"-"
+#define CLI_READ_SIZE			(64 * 1024)	//bytes read at a time from a pipe
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	bool stats;					//print bytes, time and throughput
+	bool ndjson;				//lint each line as its own JSON text
+	bool batch;					//read and lint the files together
+	uint32_t threads;			//threads to lint on, 1 for the calling thread
+	uint32_t max_depth;			//deepest nesting allowed
+	bool duplicate_keys;		//report an object with a key twice
+	bool minify;				//print each valid input without its whitespace
+	bool relaxed;				//accept comments and trailing commas
+	bool profile;				//print the profile counters of the lints
+	uint32_t max_errors;		//most errors to report of an input
+	uint32_t max_members;		//most members of an object or array, 0 for any
+	size_t max_length;			//most bytes of an input or record, 0 for any
+	size_t max_string;			//most bytes of a string, 0 for any
+	size_t max_number;			//most bytes of a number, 0 for any
+} cli_options_t;
+
+typedef struct {
+	uint8_t *text;				//text of the input
+	size_t length;				//number of bytes of text
+	bool mapped;				//text is memory mapped, not allocated
+} cli_input_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static bool ParseOptions(int argc, char **argv, cli_options_t *options, int *first_path);
+static bool OpenInput(const char *path, cli_input_t *input, size_t limit);
+static void CloseInput(cli_input_t *input);
+static bool LintInput(const char *path, cli_input_t *input, cli_options_t *options);
+static int LintBatch(int path_count, char **paths, cli_options_t *options);
+static void PrintError(const char *path, uint8_t *text, size_t offset, json_lint_error_t error,
+	json_lint_location_t *location);
+static void PrintStats(const char *path, size_t bytes, double seconds);
+static void PrintProfile(void);
+static double Now(void);
+static void PrintUsage(const char *program);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  main
+*
+* Description:
+* Lint each path given on the command line, or standard input if there are
+* none.
+*
+* Parameters:
+* argc		int			number of arguments
+* argv		char **		options followed by paths, - for standard input
+*
+* Return Value:
+* int		CLI_EXIT_VALID, CLI_EXIT_INVALID or CLI_EXIT_ERROR
+*
+* Notes:	None.
+*
+******************************************************************************/
+int main(int argc, char **argv) {
+	int status = CLI_EXIT_VALID;
+	cli_options_t options;
+	cli_input_t input;
+	int first_path = argc;
+	int path_count = 0;
+	size_t total_bytes = 0;
+	double start;
+
+	if (!ParseOptions(argc, argv, &options, &first_path)) {
+		PrintUsage(argv[0]);
+		status = CLI_EXIT_ERROR;
+	} else {
+		start = Now();
+		path_count = (first_path < argc) ? argc - first_path : 1;
+		if (options.batch && first_path < argc) {
+			status = LintBatch(path_count, &argv[first_path], &options);
+		} else {
+			for (int path = 0; path < path_count; path++) {
+				const char *name = (first_path < argc) ? argv[first_path + path] : CLI_STDIN_PATH;
+
+				if (!OpenInput(name, &input, options.ndjson ? 0 : options.max_length)) {
+					fprintf(stderr, "%s: can not read\n", name);
+					status = CLI_EXIT_ERROR;
+				} else {
+					if (!LintInput(name, &input, &options) && status == CLI_EXIT_VALID) {
+						status = CLI_EXIT_INVALID;
+					}
+					total_bytes += input.length;
+					CloseInput(&input);
+				}
+			}
+			if (options.stats && path_count > 1) {
+				PrintStats("total", total_bytes, Now() - start);
+			}
+		}
+		if (options.profile) {
+			PrintProfile();
+		}
+	}
+
+	return status;
+}
+
+/******************************************************************************
+* Function Name:  ParseOptions
+*
+* Description:
+* Read the options from the start of the command line.
+*
+* Parameters:
+* argc			int				number of arguments
+* argv			char **			arguments
+* options		cli_options_t *	options read
+* first_path	int *			index of the first path in argv
+*
+* Return Value:
+* bool		false if an option is unknown or its value is missing
+*
+* Notes:
+* Options are --stats, --ndjson, --threads N, --max-depth N, --duplicate-keys,
+* --max-length N, --max-string N, --max-number N, --max-members N, and
+* --profile, and --minify, --relaxed and --max-errors N, which can not be
+* given with --ndjson, and --batch, which can not be given with --ndjson,
+* --minify or --max-errors N.  -- ends the options.
+*
+******************************************************************************/
+static bool ParseOptions(int argc, char **argv, cli_options_t *options, int *first_path) {
+	bool valid = true;
+	int arg = 1;
+
+	options->stats = false;
+	options->ndjson = false;
+	options->batch = false;
+	options->threads = 1;
+	options->max_depth = JSON_LINT_DEPTH_MAX;
+	options->duplicate_keys = false;
+	options->minify = false;
+	options->relaxed = false;
+	options->profile = false;
+	options->max_errors = 1;
+	options->max_members = 0;
+	options->max_length = 0;
+	options->max_string = 0;
+	options->max_number = 0;
+	while (valid && arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+		if (strcmp(argv[arg], "--") == 0) {
+			arg++;
+			break;
+		} else if (strcmp(argv[arg], "--stats") == 0) {
+			options->stats = true;
+		} else if (strcmp(argv[arg], "--ndjson") == 0) {
+			options->ndjson = true;
+		} else if (strcmp(argv[arg], "--batch") == 0) {
+			options->batch = true;
+		} else if (strcmp(argv[arg], "--threads") == 0 && arg + 1 < argc) {
+			options->threads = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--max-depth") == 0 && arg + 1 < argc) {
+			options->max_depth = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--duplicate-keys") == 0) {
+			options->duplicate_keys = true;
+		} else if (strcmp(argv[arg], "--minify") == 0) {
+			options->minify = true;
+		} else if (strcmp(argv[arg], "--relaxed") == 0) {
+			options->relaxed = true;
+		} else if (strcmp(argv[arg], "--profile") == 0) {
+			options->profile = true;
+		} else if (strcmp(argv[arg], "--max-errors") == 0 && arg + 1 < argc) {
+			options->max_errors = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--max-members") == 0 && arg + 1 < argc) {
+			options->max_members = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--max-length") == 0 && arg + 1 < argc) {
+			options->max_length = (size_t)strtoull(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--max-string") == 0 && arg + 1 < argc) {
+			options->max_string = (size_t)strtoull(argv[++arg], NULL, 10);
+		} else if (strcmp(argv[arg], "--max-number") == 0 && arg + 1 < argc) {
+			options->max_number = (size_t)strtoull(argv[++arg], NULL, 10);
+		} else {
+			valid = false;
+		}
+		arg++;
+	}
+	*first_path = arg;
+	if ((options->minify || options->relaxed || options->max_errors != 1) && options->ndjson) {
+		valid = false;
+	}
+	if ((options->ndjson || options->minify || options->max_errors != 1) && options->batch) {
+		valid = false;
+	}
+
+	return valid;
+}
+
+/******************************************************************************
+* Function Name:  OpenInput
+*
+* Description:
+* Get the text of an input: a regular file is memory mapped, standard input
+* and other files are read into memory.
+*
+* Parameters:
+* path		const char *		path of the file, - for standard input
+* input		cli_input_t *		text of the input
+* limit		size_t				bytes after which to stop reading, 0 for none
+*
+* Return Value:
+* bool		false if the input can not be read
+*
+* Notes:
+* Reading stops once more than limit bytes are read, which is enough for the
+* lint to reject the text as too large.
+*
+******************************************************************************/
+static bool OpenInput(const char *path, cli_input_t *input, size_t limit) {
+	bool opened = false;
+	bool from_stdin = (strcmp(path, CLI_STDIN_PATH) == 0);
+	int file = from_stdin ? STDIN_FILENO : open(path, O_RDONLY);
+	struct stat status;
+	uint8_t *buffer;
+	size_t capacity = 0;
+	ssize_t bytes_read = 1;
+
+	input->text = NULL;
+	input->length = 0;
+	input->mapped = false;
+	if (file >= 0 && fstat(file, &status) == 0) {
+		if (S_ISREG(status.st_mode) && status.st_size > 0) {
+			input->text = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (input->text != MAP_FAILED) {
+				input->length = (size_t)status.st_size;
+				input->mapped = true;
+				madvise(input->text, input->length, MADV_SEQUENTIAL);
+				opened = true;
+			} else {
+				input->text = NULL;
+			}
+		}
+		if (!opened) {
+			opened = true;
+			while (opened && bytes_read > 0 && (limit == 0 || input->length <= limit)) {
+				if (input->length + CLI_READ_SIZE > capacity) {
+					capacity = (capacity == 0) ? CLI_READ_SIZE * 2 : capacity * 2;
+					buffer = realloc(input->text, capacity);
+					opened = (buffer != NULL);
+					input->text = opened ? buffer : input->text;
+				}
+				if (opened) {
+					bytes_read = read(file, input->text + input->length, CLI_READ_SIZE);
+					opened = (bytes_read >= 0);
+					input->length += (bytes_read > 0) ? (size_t)bytes_read : 0;
+				}
+			}
+			if (!opened) {
+				free(input->text);
+				input->text = NULL;
+			}
+		}
+	}
+	if (file >= 0 && !from_stdin) {
+		close(file);
+	}
+
+	return opened;
+}
+
+/******************************************************************************
+* Function Name:  CloseInput
+*
+* Description:
+* Release the text of an input.
+*
+* Parameters:
+* input		cli_input_t *		input opened by OpenInput()
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void CloseInput(cli_input_t *input) {
+	if (input->mapped) {
+		munmap(input->text, input->length);
+	} else {
+		free(input->text);
+	}
+	input->text = NULL;
+	input->length = 0;
+}
+
+/******************************************************************************
+* Function Name:  LintInput
+*
+* Description:
+* Lint the text of an input and print its errors and, if asked for, its
+* statistics.  With --minify a valid input is printed without its whitespace
+* on a line of its own.
+*
+* Parameters:
+* path		const char *		path printed with the errors
+* input		cli_input_t *		text of the input
+* options	cli_options_t *		options of the lint
+*
+* Return Value:
+* bool		true if the text is valid
+*
+* Notes:
+* The time printed is the time to lint, not to read the input.
+*
+******************************************************************************/
+static bool LintInput(const char *path, cli_input_t *input, cli_options_t *options) {
+	json_lint_context_t ctx;
+	json_lint_ndjson_t ndjson;
+	json_lint_arena_t arena;
+	json_lint_result_t result;
+	json_lint_location_t location;
+	json_lint_diagnostic_t *errors = NULL;
+	uint8_t *minified = NULL;
+	double start = Now();
+
+	memset(&location, 0, sizeof(location));
+
+	if (options->ndjson) {
+		LintNDJSONInit(&ndjson);
+		ndjson.threads = options->threads;
+		ndjson.max_depth = options->max_depth;
+		ndjson.duplicate_keys = options->duplicate_keys;
+		ndjson.max_members = options->max_members;
+		ndjson.max_length = options->max_length;
+		ndjson.max_string = options->max_string;
+		ndjson.max_number = options->max_number;
+		result = LintNDJSON(&ndjson, input->text, input->length);
+		if (options->stats) {
+			PrintStats(path, input->length, Now() - start);
+		}
+		for (size_t record = 0; record < ndjson.invalid; record++) {
+			PrintError(path, input->text, ndjson.errors[record].offset_invalid_json, ndjson.errors[record].error,
+				&location);
+		}
+		if (ndjson.error != ERROR_JSON_LINT_NONE) {
+			fprintf(stderr, "%s: %s\n", path, LintJSONErrorString(ndjson.error));
+		}
+		LintNDJSONFree(&ndjson);
+	} else {
+		LintJSONInit(&ctx);
+		ctx.max_depth = options->max_depth;
+		ctx.max_members = options->max_members;
+		ctx.max_length = options->max_length;
+		ctx.max_string = options->max_string;
+		ctx.max_number = options->max_number;
+		ctx.dialect = options->relaxed ? DIALECT_JSON_LINT_RELAXED : DIALECT_JSON_LINT_ECMA404;
+		memset(&arena, 0, sizeof(arena));
+		if (options->duplicate_keys) {
+			ctx.key_arena = &arena;
+		}
+		if (options->minify) {
+			minified = malloc(input->length > 0 ? input->length : 1);
+			ctx.minify = minified;
+			ctx.minify_size = input->length;
+		}
+		if (options->max_errors > 1) {
+			errors = malloc(options->max_errors * sizeof(json_lint_diagnostic_t));
+			ctx.errors = errors;
+			ctx.errors_size = (errors != NULL) ? options->max_errors : 0;
+		}
+		if (options->minify && minified == NULL) {
+			fprintf(stderr, "%s: %s\n", path, LintJSONErrorString(ERROR_JSON_LINT_NO_MEMORY));
+			result = RESULT_JSON_LINT_INVALID;
+		} else if (options->threads == 1) {
+			result = LintJSONContext(&ctx, input->text, input->length);
+		} else {
+			result = LintJSONParallel(&ctx, input->text, input->length, options->threads);
+		}
+		if (options->stats) {
+			PrintStats(path, input->length, Now() - start);
+		}
+		if (result == RESULT_JSON_LINT_SUCCESS && minified != NULL) {
+			fwrite(minified, 1, ctx.minify_length, stdout);
+			putchar(CHAR_LINEFEED);
+		} else if (result != RESULT_JSON_LINT_SUCCESS && ctx.error_count > 0) {
+			for (size_t error = 0; error < ctx.error_count; error++) {
+				PrintError(path, input->text, errors[error].offset_invalid_json, errors[error].error, &location);
+			}
+		} else if (result != RESULT_JSON_LINT_SUCCESS && ctx.error != ERROR_JSON_LINT_NONE) {
+			PrintError(path, input->text, ctx.offset_invalid_json, ctx.error, &location);
+		}
+		free(errors);
+		free(minified);
+		LintJSONArenaFree(&arena);
+	}
+
+	return (result == RESULT_JSON_LINT_SUCCESS);
+}
+
+/******************************************************************************
+* Function Name:  LintBatch
+*
+* Description:
+* Read and lint the files of the command line as one batch and print the
+* errors of each in the order of the paths.
+*
+* Parameters:
+* path_count	int				number of paths
+* paths			char **			paths of the files
+* options		cli_options_t *	options of the lint
+*
+* Return Value:
+* int		CLI_EXIT_VALID, CLI_EXIT_INVALID or CLI_EXIT_ERROR
+*
+* Notes:
+* Standard input can not be part of a batch, - is taken as a file name.
+* With --stats only the total is printed.
+*
+******************************************************************************/
+static int LintBatch(int path_count, char **paths, cli_options_t *options) {
+	int status = CLI_EXIT_VALID;
+	json_lint_batch_t batch;
+	json_lint_batch_result_t *results = malloc((size_t)path_count * sizeof(json_lint_batch_result_t));
+	double start = Now();
+
+	LintJSONBatchInit(&batch);
+	batch.threads = options->threads;
+	batch.dialect = options->relaxed ? DIALECT_JSON_LINT_RELAXED : DIALECT_JSON_LINT_ECMA404;
+	batch.max_depth = options->max_depth;
+	batch.duplicate_keys = options->duplicate_keys;
+	batch.max_members = options->max_members;
+	batch.max_length = options->max_length;
+	batch.max_string = options->max_string;
+	batch.max_number = options->max_number;
+	if (results == NULL) {
+		fprintf(stderr, "%s\n", LintJSONErrorString(ERROR_JSON_LINT_NO_MEMORY));
+		status = CLI_EXIT_ERROR;
+	} else {
+		LintJSONBatchFiles(&batch, (const char *const *)paths, (size_t)path_count, results);
+		for (int path = 0; path < path_count; path++) {
+			if (results[path].read_error != 0) {
+				fprintf(stderr, "%s: can not read\n", paths[path]);
+				status = CLI_EXIT_ERROR;
+			} else if (results[path].result != RESULT_JSON_LINT_SUCCESS) {
+				printf("%s:%zu:%zu: %s\n", paths[path], results[path].line, results[path].column,
+					LintJSONErrorString(results[path].error));
+				status = (status == CLI_EXIT_VALID) ? CLI_EXIT_INVALID : status;
+			}
+		}
+		if (options->stats) {
+			PrintStats("total", batch.bytes, Now() - start);
+		}
+	}
+	free(results);
+
+	return status;
+}
+
+/******************************************************************************
+* Function Name:  PrintError
+*
+* Description:
+* Print an error as path:line:column: reason.
+*
+* Parameters:
+* path		const char *		path of the input
+* text		uint8_t *			text of the input
+* offset	size_t				offset of the error from the start of text
+* error		json_lint_error_t	reason of the error
+* location	json_lint_location_t *	location of the last error printed of the
+*								input, 0 for none
+*
+* Return Value:	None.
+*
+* Notes:
+* The lines are only counted for an error, and from the last error of the
+* input as the errors are printed in order.
+*
+******************************************************************************/
+static void PrintError(const char *path, uint8_t *text, size_t offset, json_lint_error_t error,
+	json_lint_location_t *location) {
+	LintJSONLocate(text, offset, location);
+	printf("%s:%zu:%zu: %s\n", path, location->line, location->column, LintJSONErrorString(error));
+}
+
+/******************************************************************************
+* Function Name:  PrintStats
+*
+* Description:
+* Print the bytes, time and throughput of a lint.
+*
+* Parameters:
+* path		const char *	path of the input, or total
+* bytes		size_t			bytes linted
+* seconds	double			time taken
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void PrintStats(const char *path, size_t bytes, double seconds) {
+	double rate = (seconds > 0) ? (double)bytes / seconds / 1e6 : 0;
+
+	printf("%s: %zu bytes, %.3f ms, %.1f MB/s\n", path, bytes, seconds * 1e3, rate);
+}
+
+/******************************************************************************
+* Function Name:  PrintProfile
+*
+* Description:
+* Print the profile counters of every lint so far to standard error as one
+* line of JSON.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* The counters are all 0 unless the lint was compiled with JSON_LINT_PROFILE.
+*
+******************************************************************************/
+static void PrintProfile(void) {
+	json_lint_profile_t profile;
+	size_t length;
+	char *text;
+
+	LintJSONProfileGet(&profile);
+	length = LintJSONProfileDump(&profile, NULL, 0);
+	text = malloc(length + 1);
+	if (text != NULL) {
+		LintJSONProfileDump(&profile, text, length + 1);
+		fprintf(stderr, "%s\n", text);
+		free(text);
+	}
+}
+
+/******************************************************************************
+* Function Name:  Now
+*
+* Description:
+* Read a clock that only moves forward.
+*
+* Parameters:	None.
+*
+* Return Value:
+* double		time in seconds
+*
+* Notes:	None.
+*
+******************************************************************************/
+static double Now(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/******************************************************************************
+* Function Name:  PrintUsage
+*
+* Description:
+* Print how to use the tool.
+*
+* Parameters:
+* program	const char *	name the tool was run as
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void PrintUsage(const char *program) {
+	fprintf(stderr,
+		"usage: %s [--stats] [--ndjson] [--batch] [--threads N] [--max-depth N]\n"
+		"       [--duplicate-keys] [--max-length N] [--max-string N]\n"
+		"       [--max-number N] [--max-members N] [--minify] [--relaxed]\n"
+		"       [--profile] [--max-errors N] [path ...]\n"
+		"  Lints each JSON file, or standard input if no path or - is given.\n"
+		"  --stats        print bytes, time and MB/s of each input\n"
+		"  --ndjson       lint each line as its own JSON text\n"
+		"  --batch        read and lint many small files together\n"
+		"  --threads N    lint on N threads, 0 for one per processor\n"
+		"  --max-depth N  deepest nesting of objects and arrays allowed\n"
+		"  --duplicate-keys  report an object that has a key more than once\n"
+		"  --max-length N    most bytes of an input, or of a record with --ndjson\n"
+		"  --max-string N    most bytes between the quotes of a string\n"
+		"  --max-number N    most bytes of a number\n"
+		"  --max-members N   most members of an object or values of an array\n"
+		"  --minify          print each valid input without its whitespace\n"
+		"  --relaxed         accept // and block comments and trailing commas\n"
+		"  --profile         print the profile counters as JSON to standard error\n"
+		"  --max-errors N    go on after an error and report up to N of them\n",
+		program);
+}
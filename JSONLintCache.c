@@ -0,0 +1,737 @@
+/******************************************************************************
+* File Name:  JSONLintCache.c
+*
+* Description:
+* Implementation of the cache of lint results, kept in shards that each have
+* a hash table of their results and a list of them from most to least
+* recently used.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The hash is XXH64, seeded with a hash of the options of the context that
+* change the result, so a text linted with other limits is not found.  The
+* text is linted outside the lock of its shard; two threads missing on the
+* same text at once both lint it and the second result replaces the first.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "JSONLint.h"
+#include "JSONLintCache.h"
+
+#if !defined(JSON_LINT_NO_THREADS)
+#include <pthread.h>
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define CACHE_SHARDS_MAX		16		//most shards, a power of 2
+#define CACHE_SHARD_MIN			64		//fewest results a shard is made for
+#define CACHE_NONE				UINT32_MAX	//no entry
+
+#define HASH_PRIME_1			11400714785074694791ULL	//XXH64
+#define HASH_PRIME_2			14029467366897019727ULL
+#define HASH_PRIME_3			1609587929392839161ULL
+#define HASH_PRIME_4			9650029242287828579ULL
+#define HASH_PRIME_5			2870177450012600261ULL
+#define HASH_STRIPE				32		//bytes hashed by the 4 lanes at a time
+
+#define ROTATE_LEFT(value, bits)	(((value) << (bits)) | ((value) >> (64 - (bits))))
+
+#if defined(JSON_LINT_NO_THREADS)
+#define CACHE_LOCK(shard)
+#define CACHE_UNLOCK(shard)
+#else
+#define CACHE_LOCK(shard)		pthread_mutex_lock(&(shard)->lock)
+#define CACHE_UNLOCK(shard)		pthread_mutex_unlock(&(shard)->lock)
+#endif
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	uint64_t hash;				//hash of the text and options
+	size_t length;				//bytes of the text
+	size_t offset_invalid_json;	//offset of invalid json from the start of text
+	json_lint_stats_t stats;	//counts of the json text
+	json_lint_error_t error;	//reason the text is invalid
+	json_lint_result_t result;	//result of the lint
+	uint32_t chain;				//next entry in the same bucket
+	uint32_t newer;				//entry used after this one
+	uint32_t older;				//entry used before this one
+} cache_entry_t;
+
+typedef struct {
+#if !defined(JSON_LINT_NO_THREADS)
+	pthread_mutex_t lock;		//held to read or change the shard
+#endif
+	uint32_t capacity;			//most entries
+	uint32_t count;				//entries in use, from the start of entries
+	uint32_t newest;			//most recently used entry
+	uint32_t oldest;			//least recently used entry
+	uint32_t bucket_mask;		//buckets - 1
+	uint32_t *buckets;			//first entry of each bucket
+	cache_entry_t *entries;
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t bypassed;			//only counted in shard 0
+} cache_shard_t;
+
+struct json_lint_cache_t {
+	size_t capacity;			//most results held
+	uint32_t shard_mask;		//shards - 1
+	cache_shard_t shards[CACHE_SHARDS_MAX];
+};
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static bool ShardInit(cache_shard_t *shard, uint32_t capacity);
+static void ShardFree(cache_shard_t *shard);
+static uint32_t ShardFind(cache_shard_t *shard, uint64_t hash, size_t length);
+static void ShardInsert(cache_shard_t *shard, uint64_t hash, size_t length,
+	json_lint_context_t *ctx, json_lint_result_t result);
+static void ShardUse(cache_shard_t *shard, uint32_t index);
+static void ShardUnlink(cache_shard_t *shard, uint32_t index);
+static uint64_t CacheOptions(json_lint_context_t *ctx);
+static uint64_t CacheHash(const uint8_t *data, size_t length, uint64_t seed);
+static uint64_t HashRound(uint64_t lane, uint64_t input);
+static uint64_t HashMerge(uint64_t hash, uint64_t lane);
+static uint64_t HashRead64(const uint8_t *data);
+static uint32_t HashRead32(const uint8_t *data);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintJSONCacheCreate
+*
+* Description:
+* Allocate a cache that holds up to capacity lint results.
+*
+* Parameters:
+* capacity	size_t			most results to hold
+*
+* Return Value:
+* json_lint_cache_t *		the cache, or NULL if capacity is 0 or memory can
+*							not be allocated
+*
+* Notes:
+* The cache is split into up to CACHE_SHARDS_MAX shards, fewer for a small
+* capacity so each shard still holds CACHE_SHARD_MIN results.
+*
+******************************************************************************/
+json_lint_cache_t *LintJSONCacheCreate(size_t capacity) {
+	json_lint_cache_t *cache = NULL;
+	uint32_t shard_count = 1;
+	uint32_t shard;
+	uint32_t shard_capacity;
+	bool created = true;
+
+	if (capacity > (size_t)(CACHE_NONE - 1) * CACHE_SHARDS_MAX) {
+		capacity = (size_t)(CACHE_NONE - 1) * CACHE_SHARDS_MAX;
+	}
+	if (capacity > 0) {
+		cache = calloc(1, sizeof(json_lint_cache_t));
+	}
+	if (cache != NULL) {
+		while (shard_count < CACHE_SHARDS_MAX && capacity / (shard_count * 2) >= CACHE_SHARD_MIN) {
+			shard_count *= 2;
+		}
+		cache->capacity = capacity;
+		cache->shard_mask = shard_count - 1;
+		for (shard = 0; shard < shard_count && created; shard++) {
+			shard_capacity = (uint32_t)(capacity / shard_count + (shard < capacity % shard_count ? 1 : 0));
+			created = ShardInit(&cache->shards[shard], shard_capacity);
+		}
+		if (!created) {
+			LintJSONCacheFree(cache);
+			cache = NULL;
+		}
+	}
+
+	return cache;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONCached
+*
+* Description:
+* Lint the JSON text as LintJSONContext() does, giving the result held in the
+* cache when the same text was linted before with the same options.
+*
+* Parameters:
+* cache			json_lint_cache_t *		cache of results, NULL to not cache
+* ctx			json_lint_context_t *	context initialized by LintJSONInit()
+* ptr_text		uint8_t *				pointer to starting text to lint
+* length		size_t					number of bytes of text
+*
+* Return Value:
+* json_lint_result_t	result of linting the text
+*
+* Notes:
+* A result from the cache sets ctx->error, ctx->ptr_invalid_json,
+* ctx->offset_invalid_json and ctx->stats as linting would.  A context
+* recording a tape, looking up a pointer, minifying or recording every error
+* needs the text linted, so it bypasses the cache.  A lint that ran out of
+* memory is not cached.
+*
+******************************************************************************/
+json_lint_result_t LintJSONCached(json_lint_cache_t *cache, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length) {
+	json_lint_result_t result;
+	cache_shard_t *shard;
+	cache_entry_t found;
+	uint64_t hash;
+	uint32_t index = CACHE_NONE;
+
+	if (cache == NULL) {
+		result = LintJSONContext(ctx, ptr_text, length);
+	} else if (ctx->tape != NULL || ctx->pointer != NULL || ctx->minify != NULL || ctx->errors != NULL) {
+		shard = &cache->shards[0];
+		CACHE_LOCK(shard);
+		shard->bypassed++;
+		CACHE_UNLOCK(shard);
+		result = LintJSONContext(ctx, ptr_text, length);
+	} else {
+		hash = CacheHash(ptr_text, length, CacheOptions(ctx));
+		shard = &cache->shards[(hash >> 32) & cache->shard_mask];
+		CACHE_LOCK(shard);
+		index = ShardFind(shard, hash, length);
+		if (index != CACHE_NONE) {
+			found = shard->entries[index];
+			ShardUse(shard, index);
+			shard->hits++;
+		} else {
+			shard->misses++;
+		}
+		CACHE_UNLOCK(shard);
+
+		if (index != CACHE_NONE) {
+			LintJSONBegin(ctx);
+			result = found.result;
+			ctx->error = found.error;
+			ctx->offset_invalid_json = found.offset_invalid_json;
+			ctx->ptr_invalid_json = (result == RESULT_JSON_LINT_INVALID) ?
+				ptr_text + found.offset_invalid_json : NULL;
+			ctx->stats = found.stats;
+		} else {
+			result = LintJSONContext(ctx, ptr_text, length);
+			if (ctx->error != ERROR_JSON_LINT_NO_MEMORY) {
+				CACHE_LOCK(shard);
+				ShardInsert(shard, hash, length, ctx, result);
+				CACHE_UNLOCK(shard);
+			}
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONCacheStats
+*
+* Description:
+* Add up the counters of every shard of the cache.
+*
+* Parameters:
+* cache		json_lint_cache_t *			cache to read
+* stats		json_lint_cache_stats_t *	counters of the cache
+*
+* Return Value:	None.
+*
+* Notes:
+* Each shard is locked while it is read, so the counters can be exported
+* while other threads use the cache.
+*
+******************************************************************************/
+void LintJSONCacheStats(json_lint_cache_t *cache, json_lint_cache_stats_t *stats) {
+	cache_shard_t *shard;
+
+	memset(stats, 0, sizeof(json_lint_cache_stats_t));
+	if (cache != NULL) {
+		stats->capacity = cache->capacity;
+		for (uint32_t index = 0; index <= cache->shard_mask; index++) {
+			shard = &cache->shards[index];
+			CACHE_LOCK(shard);
+			stats->hits += shard->hits;
+			stats->misses += shard->misses;
+			stats->evictions += shard->evictions;
+			stats->bypassed += shard->bypassed;
+			stats->entries += shard->count;
+			CACHE_UNLOCK(shard);
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  LintJSONCacheFree
+*
+* Description:
+* Release a cache allocated by LintJSONCacheCreate().
+*
+* Parameters:
+* cache		json_lint_cache_t *		cache to release, may be NULL
+*
+* Return Value:	None.
+*
+* Notes:
+* No other thread may be using the cache.
+*
+******************************************************************************/
+void LintJSONCacheFree(json_lint_cache_t *cache) {
+	if (cache != NULL) {
+		for (uint32_t index = 0; index <= cache->shard_mask; index++) {
+			ShardFree(&cache->shards[index]);
+		}
+		free(cache);
+	}
+}
+
+/******************************************************************************
+* Function Name:  ShardInit
+*
+* Description:
+* Allocate the entries and buckets of an empty shard.
+*
+* Parameters:
+* shard		cache_shard_t *		shard to initialize, zeroed
+* capacity	uint32_t			most entries of the shard
+*
+* Return Value:
+* bool		true - the shard is ready, false - memory can not be allocated
+*
+* Notes:
+* There are at least as many buckets as entries, a power of 2.
+*
+******************************************************************************/
+static bool ShardInit(cache_shard_t *shard, uint32_t capacity) {
+	uint32_t buckets = 1;
+	bool ready = false;
+
+	while (buckets < capacity && buckets < ((uint32_t)1 << 31)) {
+		buckets *= 2;
+	}
+	shard->capacity = capacity;
+	shard->bucket_mask = buckets - 1;
+	shard->newest = CACHE_NONE;
+	shard->oldest = CACHE_NONE;
+	shard->buckets = malloc(sizeof(uint32_t) * buckets);
+	shard->entries = malloc(sizeof(cache_entry_t) * capacity);
+	if (shard->buckets != NULL && shard->entries != NULL) {
+		memset(shard->buckets, 0xFF, sizeof(uint32_t) * buckets);	//CACHE_NONE
+#if defined(JSON_LINT_NO_THREADS)
+		ready = true;
+#else
+		ready = (pthread_mutex_init(&shard->lock, NULL) == 0);
+#endif
+	}
+	if (!ready) {
+		free(shard->buckets);
+		free(shard->entries);
+		shard->buckets = NULL;
+		shard->entries = NULL;
+	}
+
+	return ready;
+}
+
+/******************************************************************************
+* Function Name:  ShardFree
+*
+* Description:
+* Release the entries, buckets and lock of a shard.
+*
+* Parameters:
+* shard		cache_shard_t *		shard to release
+*
+* Return Value:	None.
+*
+* Notes:
+* A shard that ShardInit() did not make ready has no memory or lock.
+*
+******************************************************************************/
+static void ShardFree(cache_shard_t *shard) {
+	if (shard->entries != NULL) {
+#if !defined(JSON_LINT_NO_THREADS)
+		pthread_mutex_destroy(&shard->lock);
+#endif
+		free(shard->buckets);
+		free(shard->entries);
+		shard->buckets = NULL;
+		shard->entries = NULL;
+	}
+}
+
+/******************************************************************************
+* Function Name:  ShardFind
+*
+* Description:
+* Find the entry of a text in a shard.
+*
+* Parameters:
+* shard		cache_shard_t *		locked shard to search
+* hash		uint64_t			hash of the text and options
+* length	size_t				bytes of the text
+*
+* Return Value:
+* uint32_t		index of the entry, or CACHE_NONE
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint32_t ShardFind(cache_shard_t *shard, uint64_t hash, size_t length) {
+	uint32_t index = shard->buckets[hash & shard->bucket_mask];
+
+	while (index != CACHE_NONE &&
+		(shard->entries[index].hash != hash || shard->entries[index].length != length)) {
+		index = shard->entries[index].chain;
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  ShardInsert
+*
+* Description:
+* Keep the result of a lint in a shard as its most recently used entry.
+*
+* Parameters:
+* shard		cache_shard_t *			locked shard to insert into
+* hash		uint64_t				hash of the text and options
+* length	size_t					bytes of the text
+* ctx		json_lint_context_t *	context the text was linted with
+* result	json_lint_result_t		result of the lint
+*
+* Return Value:	None.
+*
+* Notes:
+* A text already in the shard, added by another thread since it was looked
+* up, has its entry replaced.  Otherwise an unused entry is taken, or the
+* least recently used entry is evicted when the shard is full.
+*
+******************************************************************************/
+static void ShardInsert(cache_shard_t *shard, uint64_t hash, size_t length,
+	json_lint_context_t *ctx, json_lint_result_t result) {
+	uint32_t index = ShardFind(shard, hash, length);
+	uint32_t *link;
+	cache_entry_t *entry;
+
+	if (index != CACHE_NONE) {
+		ShardUnlink(shard, index);
+	} else if (shard->count < shard->capacity) {
+		index = shard->count++;
+		entry = &shard->entries[index];
+		entry->chain = shard->buckets[hash & shard->bucket_mask];
+		shard->buckets[hash & shard->bucket_mask] = index;
+	} else {
+		index = shard->oldest;
+		entry = &shard->entries[index];
+		link = &shard->buckets[entry->hash & shard->bucket_mask];
+		while (*link != index) {
+			link = &shard->entries[*link].chain;
+		}
+		*link = entry->chain;
+		ShardUnlink(shard, index);
+		shard->evictions++;
+		entry->chain = shard->buckets[hash & shard->bucket_mask];
+		shard->buckets[hash & shard->bucket_mask] = index;
+	}
+	entry = &shard->entries[index];
+	entry->hash = hash;
+	entry->length = length;
+	entry->offset_invalid_json = ctx->offset_invalid_json;
+	entry->stats = ctx->stats;
+	entry->error = ctx->error;
+	entry->result = result;
+	entry->older = shard->newest;
+	entry->newer = CACHE_NONE;
+	if (shard->newest != CACHE_NONE) {
+		shard->entries[shard->newest].newer = index;
+	} else {
+		shard->oldest = index;
+	}
+	shard->newest = index;
+}
+
+/******************************************************************************
+* Function Name:  ShardUse
+*
+* Description:
+* Make an entry the most recently used entry of its shard.
+*
+* Parameters:
+* shard		cache_shard_t *		locked shard of the entry
+* index		uint32_t			index of the entry
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void ShardUse(cache_shard_t *shard, uint32_t index) {
+	cache_entry_t *entry = &shard->entries[index];
+
+	if (shard->newest != index) {
+		ShardUnlink(shard, index);
+		entry->older = shard->newest;
+		entry->newer = CACHE_NONE;
+		shard->entries[shard->newest].newer = index;
+		shard->newest = index;
+	}
+}
+
+/******************************************************************************
+* Function Name:  ShardUnlink
+*
+* Description:
+* Take an entry out of the list of its shard from most to least recently
+* used.
+*
+* Parameters:
+* shard		cache_shard_t *		locked shard of the entry
+* index		uint32_t			index of the entry
+*
+* Return Value:	None.
+*
+* Notes:
+* The entry stays in its bucket.  When it was the only entry the list is left
+* empty.
+*
+******************************************************************************/
+static void ShardUnlink(cache_shard_t *shard, uint32_t index) {
+	cache_entry_t *entry = &shard->entries[index];
+
+	if (entry->newer != CACHE_NONE) {
+		shard->entries[entry->newer].older = entry->older;
+	} else {
+		shard->newest = entry->older;
+	}
+	if (entry->older != CACHE_NONE) {
+		shard->entries[entry->older].newer = entry->newer;
+	} else {
+		shard->oldest = entry->newer;
+	}
+}
+
+/******************************************************************************
+* Function Name:  CacheOptions
+*
+* Description:
+* Hash the options of a context that change the result of a lint.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context the text is linted with
+*
+* Return Value:
+* uint64_t		seed of the hash of the text
+*
+* Notes:
+* max_depth is taken as the lint clamps it, to JSON_LINT_DEPTH_MAX, so a
+* context with a larger one finds the result it stored.
+*
+******************************************************************************/
+static uint64_t CacheOptions(json_lint_context_t *ctx) {
+	uint64_t options[7];
+
+	options[0] = (ctx->max_depth > JSON_LINT_DEPTH_MAX) ? JSON_LINT_DEPTH_MAX : ctx->max_depth;
+	options[1] = ctx->max_members;
+	options[2] = ctx->max_length;
+	options[3] = ctx->max_string;
+	options[4] = ctx->max_number;
+	options[5] = (ctx->key_arena != NULL);
+	options[6] = ctx->dialect;
+
+	return CacheHash((const uint8_t *)options, sizeof(options), 0);
+}
+
+/******************************************************************************
+* Function Name:  CacheHash
+*
+* Description:
+* Hash bytes with XXH64.
+*
+* Parameters:
+* data		const uint8_t *		bytes to hash
+* length	size_t				number of bytes
+* seed		uint64_t			seed of the hash
+*
+* Return Value:
+* uint64_t		hash of the bytes
+*
+* Notes:
+* 4 lanes each take 8 bytes of every 32 byte stripe, so the multiplies of the
+* lanes overlap.  The tail is taken 8, 4 and then 1 byte at a time.
+*
+******************************************************************************/
+static uint64_t CacheHash(const uint8_t *data, size_t length, uint64_t seed) {
+	const uint8_t *end = data + length;
+	uint64_t lanes[4];
+	uint64_t hash;
+
+	if (length >= HASH_STRIPE) {
+		lanes[0] = seed + HASH_PRIME_1 + HASH_PRIME_2;
+		lanes[1] = seed + HASH_PRIME_2;
+		lanes[2] = seed;
+		lanes[3] = seed - HASH_PRIME_1;
+		while (end - data >= HASH_STRIPE) {
+			lanes[0] = HashRound(lanes[0], HashRead64(data));
+			lanes[1] = HashRound(lanes[1], HashRead64(data + 8));
+			lanes[2] = HashRound(lanes[2], HashRead64(data + 16));
+			lanes[3] = HashRound(lanes[3], HashRead64(data + 24));
+			data += HASH_STRIPE;
+		}
+		hash = ROTATE_LEFT(lanes[0], 1) + ROTATE_LEFT(lanes[1], 7) +
+			ROTATE_LEFT(lanes[2], 12) + ROTATE_LEFT(lanes[3], 18);
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			hash = HashMerge(hash, lanes[lane]);
+		}
+	} else {
+		hash = seed + HASH_PRIME_5;
+	}
+	hash += (uint64_t)length;
+	while (end - data >= 8) {
+		hash ^= HashRound(0, HashRead64(data));
+		hash = ROTATE_LEFT(hash, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+		data += 8;
+	}
+	if (end - data >= 4) {
+		hash ^= (uint64_t)HashRead32(data) * HASH_PRIME_1;
+		hash = ROTATE_LEFT(hash, 23) * HASH_PRIME_2 + HASH_PRIME_3;
+		data += 4;
+	}
+	while (data < end) {
+		hash ^= *data * HASH_PRIME_5;
+		hash = ROTATE_LEFT(hash, 11) * HASH_PRIME_1;
+		data++;
+	}
+	hash ^= hash >> 33;
+	hash *= HASH_PRIME_2;
+	hash ^= hash >> 29;
+	hash *= HASH_PRIME_3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+/******************************************************************************
+* Function Name:  HashRound
+*
+* Description:
+* Mix 8 bytes of input into a lane of the hash.
+*
+* Parameters:
+* lane		uint64_t		lane before the input
+* input		uint64_t		8 bytes of input
+*
+* Return Value:
+* uint64_t		lane after the input
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint64_t HashRound(uint64_t lane, uint64_t input) {
+	lane += input * HASH_PRIME_2;
+	lane = ROTATE_LEFT(lane, 31);
+
+	return lane * HASH_PRIME_1;
+}
+
+/******************************************************************************
+* Function Name:  HashMerge
+*
+* Description:
+* Mix a lane into the hash once the stripes are done.
+*
+* Parameters:
+* hash		uint64_t		hash before the lane
+* lane		uint64_t		lane to mix in
+*
+* Return Value:
+* uint64_t		hash after the lane
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint64_t HashMerge(uint64_t hash, uint64_t lane) {
+	hash ^= HashRound(0, lane);
+
+	return hash * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+/******************************************************************************
+* Function Name:  HashRead64
+*
+* Description:
+* Load 8 bytes that may not be aligned.
+*
+* Parameters:
+* data		const uint8_t *		bytes to load
+*
+* Return Value:
+* uint64_t		the bytes in the byte order of the target
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint64_t HashRead64(const uint8_t *data) {
+	uint64_t value;
+
+	memcpy(&value, data, sizeof(value));
+
+	return value;
+}
+
+/******************************************************************************
+* Function Name:  HashRead32
+*
+* Description:
+* Load 4 bytes that may not be aligned.
+*
+* Parameters:
+* data		const uint8_t *		bytes to load
+*
+* Return Value:
+* uint32_t		the bytes in the byte order of the target
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint32_t HashRead32(const uint8_t *data) {
+	uint32_t value;
+
+	memcpy(&value, data, sizeof(value));
+
+	return value;
+}
@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name:  JSONLintCache.h
+*
+* Description:
+* Cache of lint results for texts that are linted again and again, such as
+* configuration documents.  A text is found by a 64-bit hash of its bytes and
+* its length, so a repeated text gives its result without being linted.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The cache holds a bounded number of results and evicts the least recently
+* used one when it is full.  It is split into shards with a lock each, so
+* threads can share one cache.  Define JSON_LINT_NO_THREADS when compiling
+* for targets without POSIX threads, the cache then has no locks.
+*
+* The hash is not cryptographic.  Two texts of the same length with the same
+* hash share a result, which is only a concern for texts chosen to collide.
+*
+******************************************************************************/
+#ifndef JSON_LINT_CACHE_H_
+#define JSON_LINT_CACHE_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "JSONLint.h"
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct json_lint_cache_t json_lint_cache_t;
+
+typedef struct {
+	uint64_t hits;				//lints answered from the cache
+	uint64_t misses;			//lints of texts not in the cache
+	uint64_t evictions;			//results dropped to make room
+	uint64_t bypassed;			//lints that could not use the cache
+	size_t entries;				//results held now
+	size_t capacity;			//most results held
+} json_lint_cache_stats_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+json_lint_cache_t *LintJSONCacheCreate(size_t capacity);
+json_lint_result_t LintJSONCached(json_lint_cache_t *cache, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length);
+void LintJSONCacheStats(json_lint_cache_t *cache, json_lint_cache_stats_t *stats);
+void LintJSONCacheFree(json_lint_cache_t *cache);
+
+#endif
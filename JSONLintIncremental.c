@@ -0,0 +1,625 @@
+/******************************************************************************
+* File Name:  JSONLintIncremental.c
+*
+* Description:
+* Implementation of linting a document again after an edit.  The objects and
+* arrays of the last valid text are kept in an index in the order of their
+* open brackets, with their close bracket and the container they are inside
+* of.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The text outside of the innermost container that holds the edit is the same
+* as before, and it was valid with a value where the container is.  So when
+* the container is still one valid value on its own, the whole text is valid
+* and only the container needs to be linted.  Its objects and arrays are then
+* found again and the brackets after the edit are moved by the change in
+* length.  Finding the brackets of text already known to be valid only needs
+* the strings and comments to be skipped.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "JSONLint.h"
+#include "JSONLintIncremental.h"
+#include "JSONLintScan.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define CHAR_QUOTE				'"'
+#define CHAR_BACKSLASH			'\\'
+#define CHAR_SLASH				'/'
+#define CHAR_STAR				'*'
+#define CHAR_LINEFEED			0x0A
+#define CHAR_OBJECT_START		'{'
+#define CHAR_OBJECT_STOP		'}'
+#define CHAR_ARRAY_START		'['
+#define CHAR_ARRAY_STOP			']'
+
+#define INCREMENTAL_NONE		SIZE_MAX	//no container
+#define INCREMENTAL_OPTIONS		6		//options of the context the index
+										//depends on
+#define INCREMENTAL_SIZE_MIN	64		//fewest containers a list is made for
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	size_t open;				//offset of the open bracket
+	size_t close;				//offset of the close bracket
+	size_t parent;				//container it is inside of, INCREMENTAL_NONE
+								//for the outermost
+	uint32_t depth;				//nesting of the container, 1 for the outermost
+} incremental_container_t;
+
+typedef struct {
+	incremental_container_t *containers;	//in the order of the open brackets
+	size_t count;				//containers in use
+	size_t size;				//containers allocated
+} incremental_list_t;
+
+struct json_lint_incremental_t {
+	incremental_list_t index;	//objects and arrays of the last valid text
+	incremental_list_t scratch;	//objects and arrays of a container linted
+								//again
+	size_t length;				//bytes of the last valid text
+	size_t options[INCREMENTAL_OPTIONS];	//options the index was made with
+	bool valid;					//the last text was valid and is indexed
+	uint64_t full;
+	uint64_t partial;
+	uint64_t bytes;
+};
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static json_lint_result_t LintText(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length, const size_t *options);
+static bool LintContainer(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, const json_lint_edit_t *edit, size_t container);
+static size_t FindContainer(incremental_list_t *list, const json_lint_edit_t *edit);
+static bool IndexContainer(json_lint_incremental_t *incremental, uint8_t *ptr_text,
+	const json_lint_edit_t *edit, size_t container);
+static bool IndexText(incremental_list_t *list, uint8_t *ptr_text, size_t start, size_t end,
+	size_t base, size_t parent, uint32_t depth);
+static uint8_t *SkipString(uint8_t *index, uint8_t *end);
+static uint8_t *SkipComment(uint8_t *index, uint8_t *end);
+static bool ListReserve(incremental_list_t *list, size_t count);
+static void IncrementalOptions(json_lint_context_t *ctx, size_t *options);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintJSONIncrementalCreate
+*
+* Description:
+* Allocate the state to lint one document again after each edit.
+*
+* Parameters:	None.
+*
+* Return Value:
+* json_lint_incremental_t *	the state, or NULL if memory can not be allocated
+*
+* Notes:
+* The state holds no index until the first text is linted.
+*
+******************************************************************************/
+json_lint_incremental_t *LintJSONIncrementalCreate(void) {
+	return calloc(1, sizeof(json_lint_incremental_t));
+}
+
+/******************************************************************************
+* Function Name:  LintJSONIncremental
+*
+* Description:
+* Lint the JSON text as LintJSONContext() does, after the edit of the text
+* last given.  Only the innermost object or array that holds the edit is
+* linted when the index of the last text can be used.
+*
+* Parameters:
+* incremental	json_lint_incremental_t *	state of the document
+* ctx			json_lint_context_t *		context initialized by
+*											LintJSONInit()
+* ptr_text		uint8_t *					pointer to the text after the edit
+* length		size_t						number of bytes of text
+* edit			const json_lint_edit_t *	bytes replaced since the text last
+*											given, NULL for a new text
+*
+* Return Value:
+* json_lint_result_t	result of linting the whole text
+*
+* Notes:
+* The text outside of the edit must be the same as the text last given.  It
+* may be at another address.  An invalid result is always from linting the
+* whole text, so ctx->error and ctx->offset_invalid_json are as
+* LintJSONContext() gives.  After linting one container, ctx->stats only
+* counts the values of that container.  A context recording a tape, looking
+* up a pointer, minifying or recording every error needs the whole text
+* linted.
+*
+******************************************************************************/
+json_lint_result_t LintJSONIncremental(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length, const json_lint_edit_t *edit) {
+	json_lint_result_t result;
+	size_t options[INCREMENTAL_OPTIONS];
+	size_t container = INCREMENTAL_NONE;
+
+	IncrementalOptions(ctx, options);
+	if (incremental->valid && edit != NULL && memcmp(options, incremental->options, sizeof(options)) == 0 &&
+		ctx->tape == NULL && ctx->pointer == NULL && ctx->minify == NULL && ctx->errors == NULL &&
+		(ctx->max_length == 0 || length <= ctx->max_length) &&
+		edit->offset <= incremental->length && edit->removed <= incremental->length - edit->offset &&
+		edit->inserted <= length && length == incremental->length - edit->removed + edit->inserted) {
+		container = FindContainer(&incremental->index, edit);
+	}
+	if (container != INCREMENTAL_NONE && LintContainer(incremental, ctx, ptr_text, edit, container)) {
+		incremental->length = length;
+		result = RESULT_JSON_LINT_SUCCESS;
+	} else {
+		result = LintText(incremental, ctx, ptr_text, length, options);
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONIncrementalStats
+*
+* Description:
+* Read the counters of the lints of a document.
+*
+* Parameters:
+* incremental	json_lint_incremental_t *			state of the document
+* stats			json_lint_incremental_stats_t *		counters of the lints
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintJSONIncrementalStats(json_lint_incremental_t *incremental, json_lint_incremental_stats_t *stats) {
+	stats->full = incremental->full;
+	stats->partial = incremental->partial;
+	stats->bytes = incremental->bytes;
+	stats->containers = incremental->valid ? incremental->index.count : 0;
+}
+
+/******************************************************************************
+* Function Name:  LintJSONIncrementalFree
+*
+* Description:
+* Release the state allocated by LintJSONIncrementalCreate().
+*
+* Parameters:
+* incremental	json_lint_incremental_t *	state to release, may be NULL
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintJSONIncrementalFree(json_lint_incremental_t *incremental) {
+	if (incremental != NULL) {
+		free(incremental->index.containers);
+		free(incremental->scratch.containers);
+		free(incremental);
+	}
+}
+
+/******************************************************************************
+* Function Name:  LintText
+*
+* Description:
+* Lint the whole text and index its objects and arrays if it is valid.
+*
+* Parameters:
+* incremental	json_lint_incremental_t *	state of the document
+* ctx			json_lint_context_t *		context to lint with
+* ptr_text		uint8_t *					pointer to the text
+* length		size_t						number of bytes of text
+* options		const size_t *				options of the context
+*
+* Return Value:
+* json_lint_result_t	result of linting the text
+*
+* Notes:
+* When the index can not be allocated the next edit lints the whole text too.
+*
+******************************************************************************/
+static json_lint_result_t LintText(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length, const size_t *options) {
+	json_lint_result_t result = LintJSONContext(ctx, ptr_text, length);
+
+	incremental->full++;
+	incremental->bytes += length;
+	incremental->index.count = 0;
+	incremental->valid = (result == RESULT_JSON_LINT_SUCCESS &&
+		IndexText(&incremental->index, ptr_text, 0, length, 0, INCREMENTAL_NONE, 1));
+	incremental->length = length;
+	memcpy(incremental->options, options, sizeof(incremental->options));
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LintContainer
+*
+* Description:
+* Lint the container that holds the edit as a text of its own, and index it
+* again if it is valid.
+*
+* Parameters:
+* incremental	json_lint_incremental_t *	state of the document
+* ctx			json_lint_context_t *		context to lint with
+* ptr_text		uint8_t *					pointer to the text after the edit
+* edit			const json_lint_edit_t *	bytes replaced
+* container		size_t						index of the container
+*
+* Return Value:
+* bool		true if the container is valid and indexed, false if the whole
+*			text needs to be linted
+*
+* Notes:
+* The container is as deep as it is in the text, so its nesting is limited
+* to what is left of ctx->max_depth.
+*
+******************************************************************************/
+static bool LintContainer(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, const json_lint_edit_t *edit, size_t container) {
+	incremental_container_t *found = &incremental->index.containers[container];
+	size_t open = found->open;
+	size_t close = found->close - edit->removed + edit->inserted;
+	uint32_t max_depth = ctx->max_depth;
+	bool relinted;
+
+	ctx->max_depth = ((max_depth > JSON_LINT_DEPTH_MAX) ? JSON_LINT_DEPTH_MAX : max_depth) - (found->depth - 1);
+	relinted = (LintJSONContext(ctx, ptr_text + open, close - open + 1) == RESULT_JSON_LINT_SUCCESS);
+	ctx->max_depth = max_depth;
+	incremental->partial++;
+	incremental->bytes += close - open + 1;
+	if (relinted) {
+		relinted = IndexContainer(incremental, ptr_text, edit, container);
+	}
+
+	return relinted;
+}
+
+/******************************************************************************
+* Function Name:  FindContainer
+*
+* Description:
+* Find the innermost container of the index that holds all of the bytes
+* replaced by the edit, not counting its brackets.
+*
+* Parameters:
+* list		incremental_list_t *		index of the text before the edit
+* edit		const json_lint_edit_t *	bytes replaced
+*
+* Return Value:
+* size_t		index of the container, INCREMENTAL_NONE if there is none
+*
+* Notes:
+* The innermost container is the last one opened before the edit or one that
+* it is inside of.
+*
+******************************************************************************/
+static size_t FindContainer(incremental_list_t *list, const json_lint_edit_t *edit) {
+	size_t low = 0;
+	size_t high = list->count;
+	size_t middle;
+	size_t container = INCREMENTAL_NONE;
+
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (list->containers[middle].open < edit->offset) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low > 0) {
+		container = low - 1;
+	}
+	while (container != INCREMENTAL_NONE && list->containers[container].close < edit->offset + edit->removed) {
+		container = list->containers[container].parent;
+	}
+
+	return container;
+}
+
+/******************************************************************************
+* Function Name:  IndexContainer
+*
+* Description:
+* Replace the containers inside of the container that holds the edit with the
+* ones found in its text now, and move the brackets after the edit.
+*
+* Parameters:
+* incremental	json_lint_incremental_t *	state of the document
+* ptr_text		uint8_t *					pointer to the text after the edit
+* edit			const json_lint_edit_t *	bytes replaced
+* container		size_t						index of the container
+*
+* Return Value:
+* bool		true if the index has been updated, false if memory for it can not
+*			be allocated
+*
+* Notes:
+* The containers inside of it follow the container in the index, so they are
+* replaced in one move of the containers after them.
+*
+******************************************************************************/
+static bool IndexContainer(json_lint_incremental_t *incremental, uint8_t *ptr_text,
+	const json_lint_edit_t *edit, size_t container) {
+	incremental_list_t *index = &incremental->index;
+	incremental_list_t *scratch = &incremental->scratch;
+	incremental_container_t *containers;
+	size_t close = index->containers[container].close;
+	size_t after = container + 1;	//first container after the found one
+	size_t inside;					//containers inside of the found one now
+	size_t entry;
+	bool indexed;
+
+	while (after < index->count && index->containers[after].open < close) {
+		after++;
+	}
+	close = close - edit->removed + edit->inserted;
+	scratch->count = 0;
+	indexed = IndexText(scratch, ptr_text, index->containers[container].open + 1, close, container + 1,
+		container, index->containers[container].depth + 1);
+	inside = scratch->count;
+	if (indexed) {
+		indexed = ListReserve(index, index->count - (after - container - 1) + inside);
+	}
+	if (indexed) {
+		containers = index->containers;
+		memmove(&containers[container + 1 + inside], &containers[after],
+			(index->count - after) * sizeof(incremental_container_t));
+		if (inside > 0) {
+			memcpy(&containers[container + 1], scratch->containers, inside * sizeof(incremental_container_t));
+		}
+		index->count = index->count - (after - container - 1) + inside;
+		for (entry = container + 1 + inside; entry < index->count; entry++) {
+			containers[entry].open = containers[entry].open - edit->removed + edit->inserted;
+			containers[entry].close = containers[entry].close - edit->removed + edit->inserted;
+			if (containers[entry].parent != INCREMENTAL_NONE && containers[entry].parent >= after) {
+				containers[entry].parent = containers[entry].parent - (after - container - 1) + inside;
+			}
+		}
+		for (entry = container; entry != INCREMENTAL_NONE; entry = containers[entry].parent) {
+			containers[entry].close = containers[entry].close - edit->removed + edit->inserted;
+		}
+	}
+
+	return indexed;
+}
+
+/******************************************************************************
+* Function Name:  IndexText
+*
+* Description:
+* Add the objects and arrays of valid text to the end of a list.
+*
+* Parameters:
+* list		incremental_list_t *	list to add to
+* ptr_text	uint8_t *				pointer to the text
+* start		size_t					offset of the first byte to index
+* end		size_t					offset of one past the last byte to index
+* base		size_t					index in the list of the first container
+*									added, when the list is moved into an index
+* parent	size_t					container the text is inside of, or
+*									INCREMENTAL_NONE
+* depth		uint32_t				nesting of a container opened at start
+*
+* Return Value:
+* bool		true if the text has been indexed, false if memory for the list
+*			can not be allocated
+*
+* Notes:
+* The text between start and end must be valid and hold whole values only.
+*
+******************************************************************************/
+static bool IndexText(incremental_list_t *list, uint8_t *ptr_text, size_t start, size_t end,
+	size_t base, size_t parent, uint32_t depth) {
+	uint8_t *index = ptr_text + start;
+	uint8_t *stop = ptr_text + end;
+	incremental_container_t *entry;
+	bool indexed = true;
+
+	while (index < stop && indexed) {
+		switch (*index) {
+		case CHAR_QUOTE:
+			index = SkipString(index + 1, stop);
+			break;
+		case CHAR_SLASH:
+			index = SkipComment(index + 1, stop);
+			break;
+		case CHAR_OBJECT_START:
+		case CHAR_ARRAY_START:
+			if ((indexed = ListReserve(list, list->count + 1))) {
+				entry = &list->containers[list->count];
+				entry->open = (size_t)(index - ptr_text);
+				entry->close = entry->open;
+				entry->parent = parent;
+				entry->depth = depth;
+				parent = base + list->count;
+				list->count++;
+				depth++;
+			}
+			index++;
+			break;
+		case CHAR_OBJECT_STOP:
+		case CHAR_ARRAY_STOP:
+			entry = &list->containers[parent - base];
+			entry->close = (size_t)(index - ptr_text);
+			parent = entry->parent;
+			depth--;
+			index++;
+			break;
+		default:
+			index++;
+			break;
+		}
+	}
+
+	return indexed;
+}
+
+/******************************************************************************
+* Function Name:  SkipString
+*
+* Description:
+* Skip the rest of a valid string.
+*
+* Parameters:
+* index		uint8_t *		pointer to the byte after the open quote
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the byte after the close quote
+*
+* Notes:
+* The text is skipped by ScanString() up to each backslash, and the byte after
+* a backslash is skipped with it.
+*
+******************************************************************************/
+static uint8_t *SkipString(uint8_t *index, uint8_t *end) {
+	index = ScanString(index, end);
+	while (index < end && *index != CHAR_QUOTE) {
+		index += (*index == CHAR_BACKSLASH) ? 2 : 1;
+		index = ScanString(index, end);
+	}
+
+	return (index < end) ? index + 1 : end;
+}
+
+/******************************************************************************
+* Function Name:  SkipComment
+*
+* Description:
+* Skip the rest of a valid line or block comment of the relaxed dialect.
+*
+* Parameters:
+* index		uint8_t *		pointer to the byte after the first slash
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the byte after the comment
+*
+* Notes:
+* A line comment ends with its line feed, or at the end of the text.
+*
+******************************************************************************/
+static uint8_t *SkipComment(uint8_t *index, uint8_t *end) {
+	uint8_t *found = NULL;
+
+	if (index < end && *index == CHAR_SLASH) {
+		found = memchr(index + 1, CHAR_LINEFEED, (size_t)(end - index - 1));
+	} else if (index < end) {
+		index++;
+		while (index < end && (found = memchr(index, CHAR_STAR, (size_t)(end - index))) != NULL &&
+			(found + 1 == end || found[1] != CHAR_SLASH)) {
+			index = found + 1;
+			found = NULL;
+		}
+		found = (found != NULL) ? found + 1 : NULL;
+	}
+
+	return (found != NULL) ? found + 1 : end;
+}
+
+/******************************************************************************
+* Function Name:  ListReserve
+*
+* Description:
+* Make room in a list for a number of containers.
+*
+* Parameters:
+* list		incremental_list_t *	list to grow
+* count		size_t					containers the list needs to hold
+*
+* Return Value:
+* bool		true if the list holds count containers, false if memory can not
+*			be allocated
+*
+* Notes:
+* The list doubles in size, so adding the containers one at a time takes
+* linear time.
+*
+******************************************************************************/
+static bool ListReserve(incremental_list_t *list, size_t count) {
+	incremental_container_t *containers;
+	size_t size = (list->size < INCREMENTAL_SIZE_MIN) ? INCREMENTAL_SIZE_MIN : list->size;
+	bool reserved = true;
+
+	if (count > list->size) {
+		while (size < count) {
+			size *= 2;
+		}
+		containers = realloc(list->containers, size * sizeof(incremental_container_t));
+		if (containers != NULL) {
+			list->containers = containers;
+			list->size = size;
+		} else {
+			reserved = false;
+		}
+	}
+
+	return reserved;
+}
+
+/******************************************************************************
+* Function Name:  IncrementalOptions
+*
+* Description:
+* Get the options of the context that change whether a text is valid.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context to read
+* options	size_t *				INCREMENTAL_OPTIONS values of the options
+*
+* Return Value:	None.
+*
+* Notes:
+* ctx->max_length is not kept, the length of each text is checked against
+* it.  ctx->max_depth is read as the lint limits it.
+*
+******************************************************************************/
+static void IncrementalOptions(json_lint_context_t *ctx, size_t *options) {
+	options[0] = (ctx->max_depth > JSON_LINT_DEPTH_MAX) ? JSON_LINT_DEPTH_MAX : ctx->max_depth;
+	options[1] = ctx->max_members;
+	options[2] = ctx->max_string;
+	options[3] = ctx->max_number;
+	options[4] = ctx->dialect;
+	options[5] = (ctx->key_arena != NULL);
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+* File Name:  JSONLintIncremental.h
+*
+* Description:
+* Lints a document again after an edit, such as a keystroke in an editor,
+* without linting all of it.  An index of the objects and arrays of the last
+* valid text is kept, and only the innermost one that holds the edit is
+* linted again.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The whole text is linted when there is no index to use: the first time, after
+* an invalid text, after a change of the options of the context, or when the
+* edit is not inside an object or array.  It is also linted when the container
+* that holds the edit is no longer valid on its own, so the error reported is
+* always the first error of the whole text.
+*
+******************************************************************************/
+#ifndef JSON_LINT_INCREMENTAL_H_
+#define JSON_LINT_INCREMENTAL_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "JSONLint.h"
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct json_lint_incremental_t json_lint_incremental_t;
+
+typedef struct {
+	size_t offset;				//offset of the first byte replaced, the same
+								//before and after the edit
+	size_t removed;				//bytes of the text before the edit replaced
+	size_t inserted;			//bytes of the text after the edit that replace
+								//them
+} json_lint_edit_t;
+
+typedef struct {
+	uint64_t full;				//lints of the whole text
+	uint64_t partial;			//lints of one object or array
+	uint64_t bytes;				//bytes of text linted
+	size_t containers;			//objects and arrays in the index now
+} json_lint_incremental_stats_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+json_lint_incremental_t *LintJSONIncrementalCreate(void);
+json_lint_result_t LintJSONIncremental(json_lint_incremental_t *incremental, json_lint_context_t *ctx,
+	uint8_t *ptr_text, size_t length, const json_lint_edit_t *edit);
+void LintJSONIncrementalStats(json_lint_incremental_t *incremental, json_lint_incremental_stats_t *stats);
+void LintJSONIncrementalFree(json_lint_incremental_t *incremental);
+
+#endif
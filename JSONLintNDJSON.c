@@ -0,0 +1,311 @@
+/******************************************************************************
+* File Name:  JSONLintNDJSON.c
+*
+* Description:
+* Implementation of newline delimited JSON linting on a worker pool.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The text is cut into blocks of a fixed size without reading it first.  A
+* record belongs to the block holding its first byte and is linted whole by
+* that block's task even if it runs past the end of the block.  Each task
+* counts its lines, so line numbers are found once all blocks are done by
+* adding up the counts of the blocks before.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "JSONLint.h"
+#include "JSONLintNDJSON.h"
+#include "JSONLintPool.h"
+#include "JSONLintScan.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define CHAR_LINEFEED			0x0A
+
+#define NDJSON_BLOCK_SIZE		(256 * 1024)	//bytes of text per task
+#define NDJSON_ERRORS_INITIAL		8		//errors a block has room for at first
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	size_t lines;				//lines starting in the block
+	size_t records;				//records starting in the block
+	size_t invalid;				//invalid records starting in the block
+	size_t capacity;			//room in errors
+	json_lint_ndjson_error_t *errors;	//invalid records, line counted from
+								//the start of the block
+	json_lint_stats_t stats;	//counts of the json of the records
+	bool no_memory;				//an error could not be kept
+} ndjson_block_t;
+
+typedef struct {
+	json_lint_ndjson_t *ndjson;
+	uint8_t *text;
+	size_t length;
+	ndjson_block_t *blocks;
+} ndjson_run_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void LintNDJSONBlock(void *arg, uint32_t task, uint32_t worker);
+static void AddError(ndjson_block_t *block, size_t offset, json_lint_context_t *ctx);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintNDJSONInit
+*
+* Description:
+* Set the options of an NDJSON lint to their defaults: one thread per
+* processor and nesting up to JSON_LINT_DEPTH_MAX.
+*
+* Parameters:
+* ndjson	json_lint_ndjson_t *	options and results to initialize
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintNDJSONInit(json_lint_ndjson_t *ndjson) {
+	memset(ndjson, 0, sizeof(json_lint_ndjson_t));
+	ndjson->max_depth = JSON_LINT_DEPTH_MAX;
+	ndjson->duplicate_keys = false;
+}
+
+/******************************************************************************
+* Function Name:  LintNDJSON
+*
+* Description:
+* Lint every line of newline delimited JSON text as a JSON text of its own.
+*
+* Parameters:
+* ndjson	json_lint_ndjson_t *	options, set with LintNDJSONInit(), and
+*									results of the lint
+* ptr_text	uint8_t *				pointer to the text, such as a memory
+*									mapped file
+* length	size_t					number of bytes of text
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS if every record is valid,
+*						otherwise RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* ndjson->errors is allocated when a record is invalid and is released by
+* LintNDJSONFree().  Text with no records is valid.
+*
+******************************************************************************/
+json_lint_result_t LintNDJSON(json_lint_ndjson_t *ndjson, uint8_t *ptr_text, size_t length) {
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
+	ndjson_run_t run;
+	uint32_t block_count = (uint32_t)((length + NDJSON_BLOCK_SIZE - 1) / NDJSON_BLOCK_SIZE);
+	size_t lines = 0;
+	size_t invalid = 0;
+
+	ndjson->error = ERROR_JSON_LINT_NONE;
+	ndjson->lines = 0;
+	ndjson->records = 0;
+	ndjson->invalid = 0;
+	ndjson->errors = NULL;
+	memset(&ndjson->stats, 0, sizeof(ndjson->stats));
+
+	run.ndjson = ndjson;
+	run.text = ptr_text;
+	run.length = length;
+	run.blocks = calloc((block_count > 0) ? block_count : 1, sizeof(ndjson_block_t));
+	if (run.blocks == NULL) {
+		ndjson->error = ERROR_JSON_LINT_NO_MEMORY;
+	} else {
+		PoolRun(ndjson->threads, block_count, LintNDJSONBlock, &run);
+
+		for (uint32_t block = 0; block < block_count; block++) {
+			ndjson->invalid += run.blocks[block].invalid;
+			if (run.blocks[block].no_memory) {
+				ndjson->error = ERROR_JSON_LINT_NO_MEMORY;
+			}
+		}
+		if (ndjson->invalid > 0 && ndjson->error == ERROR_JSON_LINT_NONE) {
+			ndjson->errors = malloc(ndjson->invalid * sizeof(json_lint_ndjson_error_t));
+			if (ndjson->errors == NULL) {
+				ndjson->error = ERROR_JSON_LINT_NO_MEMORY;
+			}
+		}
+		for (uint32_t block = 0; block < block_count; block++) {
+			for (size_t error = 0; ndjson->errors != NULL && error < run.blocks[block].invalid; error++) {
+				ndjson->errors[invalid] = run.blocks[block].errors[error];
+				ndjson->errors[invalid].line += lines;
+				invalid++;
+			}
+			lines += run.blocks[block].lines;
+			ndjson->records += run.blocks[block].records;
+			LintJSONAddStats(&ndjson->stats, &run.blocks[block].stats);
+			free(run.blocks[block].errors);
+		}
+		ndjson->lines = lines;
+		free(run.blocks);
+
+		if (ndjson->invalid == 0 && ndjson->error == ERROR_JSON_LINT_NONE) {
+			result = RESULT_JSON_LINT_SUCCESS;
+		}
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LintNDJSONFree
+*
+* Description:
+* Release the errors of an NDJSON lint.
+*
+* Parameters:
+* ndjson	json_lint_ndjson_t *	results of LintNDJSON()
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void LintNDJSONFree(json_lint_ndjson_t *ndjson) {
+	free(ndjson->errors);
+	ndjson->errors = NULL;
+	ndjson->invalid = 0;
+}
+
+/******************************************************************************
+* Function Name:  LintNDJSONBlock
+*
+* Description:
+* Lint the records that start in one block of the text.
+*
+* Parameters:
+* arg		void *		pointer to the ndjson_run_t of the lint
+* task		uint32_t	number of the block
+* worker	uint32_t	number of the worker running the task, not used
+*
+* Return Value:	None.
+*
+* Notes:
+* A line starts at the start of the text and after every line feed that is
+* not the last byte of the text.
+*
+******************************************************************************/
+static void LintNDJSONBlock(void *arg, uint32_t task, uint32_t worker) {
+	ndjson_run_t *run = arg;
+	ndjson_block_t *block = &run->blocks[task];
+	json_lint_context_t ctx;
+	json_lint_arena_t arena;
+	uint8_t *text_end = run->text + run->length;
+	uint8_t *block_end;
+	uint8_t *line = run->text + (size_t)task * NDJSON_BLOCK_SIZE;
+	uint8_t *line_end;
+
+	(void)worker;
+	block_end = (text_end - line > NDJSON_BLOCK_SIZE) ? line + NDJSON_BLOCK_SIZE : text_end;
+	if (line != run->text && line[-1] != CHAR_LINEFEED) {
+		line = memchr(line, CHAR_LINEFEED, block_end - line);
+		line = (line != NULL) ? line + 1 : block_end;
+	}
+
+	LintJSONInit(&ctx);
+	ctx.max_depth = run->ndjson->max_depth;
+	ctx.max_members = run->ndjson->max_members;
+	ctx.max_length = run->ndjson->max_length;
+	ctx.max_string = run->ndjson->max_string;
+	ctx.max_number = run->ndjson->max_number;
+	memset(&arena, 0, sizeof(arena));
+	if (run->ndjson->duplicate_keys) {
+		ctx.key_arena = &arena;
+	}
+	while (line < block_end) {
+		line_end = memchr(line, CHAR_LINEFEED, text_end - line);
+		if (line_end == NULL) {
+			line_end = text_end;
+		}
+		block->lines++;
+		if (ScanWhitespace(line, line_end) != line_end) {
+			block->records++;
+			if (LintJSONContext(&ctx, line, line_end - line) != RESULT_JSON_LINT_SUCCESS) {
+				AddError(block, line - run->text, &ctx);
+			}
+			LintJSONAddStats(&block->stats, &ctx.stats);
+		}
+		line = (line_end < text_end) ? line_end + 1 : text_end;
+	}
+	LintJSONArenaFree(&arena);
+}
+
+/******************************************************************************
+* Function Name:  AddError
+*
+* Description:
+* Keep the location and reason of an invalid record of a block.
+*
+* Parameters:
+* block		ndjson_block_t *		block the record starts in
+* offset	size_t					offset of the record from the start of text
+* ctx		json_lint_context_t *	context the record was linted with
+*
+* Return Value:	None.
+*
+* Notes:
+* The line is kept counted from the start of the block, block->lines already
+* counts the record's line.
+*
+******************************************************************************/
+static void AddError(ndjson_block_t *block, size_t offset, json_lint_context_t *ctx) {
+	json_lint_ndjson_error_t *errors = block->errors;
+	size_t capacity = block->capacity;
+
+	if (block->invalid == capacity) {
+		capacity = (capacity == 0) ? NDJSON_ERRORS_INITIAL : capacity * 2;
+		errors = realloc(block->errors, capacity * sizeof(json_lint_ndjson_error_t));
+		if (errors == NULL) {
+			block->no_memory = true;
+		} else {
+			block->errors = errors;
+			block->capacity = capacity;
+		}
+	}
+	if (errors != NULL) {
+		errors[block->invalid].line = block->lines;
+		errors[block->invalid].offset = offset;
+		errors[block->invalid].offset_invalid_json = offset + ctx->offset_invalid_json;
+		errors[block->invalid].error = ctx->error;
+		block->invalid++;
+	}
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name:  JSONLintNDJSON.h
+*
+* Description:
+* Lints newline delimited JSON (NDJSON, JSON Lines), one JSON text per line,
+* on several threads.  The line number and offset of every invalid record is
+* reported.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Lines that are empty or only whitespace are skipped.  A line may end with a
+* carriage return and line feed.
+*
+******************************************************************************/
+#ifndef JSON_LINT_NDJSON_H_
+#define JSON_LINT_NDJSON_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "JSONLint.h"
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	size_t line;				//line number of the record, from 1
+	size_t offset;				//offset of the record from the start of text
+	size_t offset_invalid_json;	//offset of invalid json from the start of text
+	json_lint_error_t error;	//reason the record is invalid
+} json_lint_ndjson_error_t;
+
+typedef struct {
+	uint32_t threads;			//option: threads to lint on, 0 for one per
+								//processor
+	uint32_t max_depth;			//option: deepest nesting allowed in a record
+	bool duplicate_keys;		//option: report an object with a key twice
+	uint32_t max_members;		//option: most members of an object or values
+								//of an array, 0 for no limit
+	size_t max_length;			//option: most bytes of a record, 0 for no limit
+	size_t max_string;			//option: most bytes of a string, 0 for no limit
+	size_t max_number;			//option: most bytes of a number, 0 for no limit
+	json_lint_error_t error;	//ERROR_JSON_LINT_NO_MEMORY if the results could
+								//not be kept, otherwise ERROR_JSON_LINT_NONE
+	size_t lines;				//number of lines
+	size_t records;				//number of lines holding a record
+	size_t invalid;				//number of invalid records
+	json_lint_ndjson_error_t *errors;	//the invalid records in order of offset
+	json_lint_stats_t stats;	//counts of the json of all records
+} json_lint_ndjson_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void LintNDJSONInit(json_lint_ndjson_t *ndjson);
+json_lint_result_t LintNDJSON(json_lint_ndjson_t *ndjson, uint8_t *ptr_text, size_t length);
+void LintNDJSONFree(json_lint_ndjson_t *ndjson);
+
+#endif
@@ -0,0 +1,661 @@
+/******************************************************************************
+* File Name:  JSONLintParallel.c
+*
+* Description:
+* Implementation of linting one JSON text on several threads.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The text is cut into chunks and linted in 4 passes:
+*		1. Each chunk counts its quotes that are not escaped, on the pool.  A
+*		   quote is escaped by an odd run of backslashes before it, a run
+*		   that crosses the start of the chunk is found by looking back.  The
+*		   chunk is read in blocks of 64 bytes with one mask bit per byte.
+*		2. The counts are added up to find which chunks start inside a string.
+*		3. Each chunk finds its first comma outside of a string and sums up the
+*		   brackets and braces before and after it, on the pool.  The sums are
+*		   joined in order to find the open objects and arrays at each comma.
+*		4. The text between the commas is linted by the lint engine on the pool,
+*		   each piece started with the objects and arrays open at its comma.
+* A piece is only known to start in the right state if the piece before it
+* was valid and ended in the state the next one was started in.  The pieces
+* are checked in order, at the first piece that fails the check the lint
+* continues on the calling thread from where that piece ended, so the result
+* is always the same as linting on one thread.  Speculation only goes wrong
+* for invalid text, such as a backslash outside of a string.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "JSONLint.h"
+#include "JSONLintParallel.h"
+#include "JSONLintPool.h"
+#include "JSONLintScan.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define CHAR_BACKSLASH			'\\'
+
+#if !defined(PARALLEL_CHUNK_MIN)
+#define PARALLEL_CHUNK_MIN		(1024 * 1024)	//smallest chunk worth a task
+#endif
+#define PARALLEL_CHUNKS_PER_WORKER	4		//chunks per worker, spare chunks
+							//balance uneven chunks
+#define PARALLEL_STACK_WORDS		((JSON_LINT_DEPTH_MAX + 63) / 64)
+
+#define STACK_BIT(depth)		((uint64_t)1 << ((depth) % 64))
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	uint32_t closes;			//closes of objects and arrays opened before
+								//the piece
+	uint32_t opens;				//objects and arrays still open at the end
+	uint64_t stack[PARALLEL_STACK_WORDS];	//1 bit per open, 1=object 0=array
+	bool too_deep;				//more opens than a stack can hold
+} parallel_piece_t;
+
+typedef struct {
+	uint8_t *start;				//first byte of the chunk
+	uint8_t *end;				//one past the last byte of the chunk
+	bool escaped;				//first byte follows an odd run of backslashes
+	bool quotes_odd;			//odd number of quotes not escaped
+	bool in_string;				//chunk starts inside a string
+	uint8_t *split;				//first comma outside of a string, or NULL
+	parallel_piece_t head;		//brackets before split, or of the whole chunk
+	parallel_piece_t tail;		//brackets after split
+} parallel_chunk_t;
+
+typedef struct {
+	uint8_t *start;				//first byte of the segment, after a comma
+	uint8_t *end;				//one past the last byte, after the next comma
+	uint32_t depth;				//objects and arrays open at the start
+	uint64_t stack[PARALLEL_STACK_WORDS];	//1 bit per open, 1=object 0=array
+	json_lint_result_t result;	//result of linting the segment
+	json_lint_context_t ctx;	//context the segment was linted with
+} parallel_segment_t;
+
+typedef struct {
+	uint8_t *text;
+	uint8_t *end;
+	uint32_t max_depth;
+	json_lint_context_t *options;	//context whose limits the segments are
+								//linted with
+	uint32_t chunk_count;
+	parallel_chunk_t *chunks;
+	uint32_t segment_count;
+	parallel_segment_t *segments;
+} parallel_run_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void CountQuotes(void *arg, uint32_t task, uint32_t worker);
+static void FindStructure(void *arg, uint32_t task, uint32_t worker);
+static void FindSegments(parallel_run_t *run);
+static void LintSegment(void *arg, uint32_t task, uint32_t worker);
+static json_lint_result_t JoinSegments(parallel_run_t *run, json_lint_context_t *ctx);
+static void LoadBlock(uint8_t *block, uint8_t *end, scan_structure_t *masks);
+static uint64_t FindEscaped(uint64_t backslash, uint64_t *escape_carry);
+static uint64_t PrefixXor(uint64_t mask);
+static void AddOpen(parallel_piece_t *piece, bool object);
+static void AddClose(parallel_piece_t *piece);
+static bool ApplyPiece(parallel_piece_t *piece, uint32_t *depth, uint64_t *stack, uint32_t max_depth);
+static bool SameState(json_lint_context_t *ctx, parallel_segment_t *next);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintJSONParallel
+*
+* Description:
+* Lint a JSON text on several threads.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context initialized by LintJSONInit()
+* ptr_text	uint8_t *				pointer to the text
+* length	size_t					number of bytes of text
+* threads	uint32_t				threads to lint on, 0 for one per processor
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS or RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* The context holds the same error, location and counts as LintJSONContext()
+* gives.  If memory for the chunks can not be allocated, ctx->tape,
+* ctx->key_arena, ctx->minify, ctx->errors or ctx->max_members is set,
+* ctx->dialect is not DIALECT_JSON_LINT_ECMA404, or the text is longer than
+* ctx->max_length, the text is linted on the calling thread.
+*
+******************************************************************************/
+json_lint_result_t LintJSONParallel(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length, uint32_t threads) {
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
+	parallel_run_t run;
+	size_t chunk_count = length / PARALLEL_CHUNK_MIN;
+	bool in_string = false;
+
+	if (threads == 0) {
+		threads = PoolWorkerCount();
+	}
+	if (chunk_count > (size_t)threads * PARALLEL_CHUNKS_PER_WORKER) {
+		chunk_count = (size_t)threads * PARALLEL_CHUNKS_PER_WORKER;
+	}
+	run.text = ptr_text;
+	run.end = ptr_text + length;
+	run.max_depth = (ctx->max_depth < JSON_LINT_DEPTH_MAX) ? ctx->max_depth : JSON_LINT_DEPTH_MAX;
+	run.options = ctx;
+	run.chunk_count = (uint32_t)chunk_count;
+	run.chunks = NULL;
+	run.segment_count = 0;
+	run.segments = NULL;
+	if (threads > 1 && chunk_count > 1 && ctx->tape == NULL && ctx->key_arena == NULL &&
+		ctx->minify == NULL && ctx->errors == NULL && ctx->max_members == 0 &&
+		ctx->dialect == DIALECT_JSON_LINT_ECMA404 &&
+		(ctx->max_length == 0 || length <= ctx->max_length)) {
+		run.chunks = calloc(chunk_count, sizeof(parallel_chunk_t));
+		run.segments = calloc(chunk_count + 1, sizeof(parallel_segment_t));
+	}
+
+	if (run.chunks == NULL || run.segments == NULL) {
+		result = LintJSONContext(ctx, ptr_text, length);
+	} else {
+		for (uint32_t chunk = 0; chunk < run.chunk_count; chunk++) {
+			run.chunks[chunk].start = ptr_text + length / chunk_count * chunk;
+			run.chunks[chunk].end = (chunk + 1 < run.chunk_count) ? ptr_text + length / chunk_count * (chunk + 1) : run.end;
+		}
+		PoolRun(threads, run.chunk_count, CountQuotes, &run);
+		for (uint32_t chunk = 0; chunk < run.chunk_count; chunk++) {
+			run.chunks[chunk].in_string = in_string;
+			in_string ^= run.chunks[chunk].quotes_odd;
+		}
+		PoolRun(threads, run.chunk_count, FindStructure, &run);
+		FindSegments(&run);
+		if (run.segment_count > 1) {
+			PoolRun(threads, run.segment_count, LintSegment, &run);
+			result = JoinSegments(&run, ctx);
+		} else {
+			result = LintJSONContext(ctx, ptr_text, length);
+		}
+	}
+	free(run.chunks);
+	free(run.segments);
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  CountQuotes
+*
+* Description:
+* Find whether a chunk has an odd number of quotes that are not escaped.
+*
+* Parameters:
+* arg		void *		pointer to the parallel_run_t of the lint
+* task		uint32_t	number of the chunk
+* worker	uint32_t	number of the worker running the task, not used
+*
+* Return Value:	None.
+*
+* Notes:
+* Escapes are followed as if every backslash is inside a string, which is
+* true for valid text.
+*
+******************************************************************************/
+static void CountQuotes(void *arg, uint32_t task, uint32_t worker) {
+	parallel_run_t *run = arg;
+	parallel_chunk_t *chunk = &run->chunks[task];
+	scan_structure_t masks;
+	uint8_t *before = chunk->start;
+	uint64_t escape_carry;
+	uint32_t quotes = 0;
+
+	(void)worker;
+	while (before > run->text && before[-1] == CHAR_BACKSLASH) {
+		before--;
+	}
+	chunk->escaped = ((chunk->start - before) % 2 == 1);
+	escape_carry = chunk->escaped;
+	for (uint8_t *block = chunk->start; block < chunk->end; block += SCAN_BLOCK_SIZE) {
+		LoadBlock(block, chunk->end, &masks);
+		quotes += CountBits(masks.quote & ~FindEscaped(masks.backslash, &escape_carry));
+	}
+	chunk->quotes_odd = (quotes % 2 == 1);
+}
+
+/******************************************************************************
+* Function Name:  FindStructure
+*
+* Description:
+* Find the first comma outside of a string in a chunk and sum up the brackets
+* and braces outside of strings before and after it.
+*
+* Parameters:
+* arg		void *		pointer to the parallel_run_t of the lint
+* task		uint32_t	number of the chunk
+* worker	uint32_t	number of the worker running the task, not used
+*
+* Return Value:	None.
+*
+* Notes:
+* The bytes inside strings of a block are found at once from the quotes that
+* are not escaped, the mask of each quote's inside is the xor of all quotes
+* before it.
+*
+******************************************************************************/
+static void FindStructure(void *arg, uint32_t task, uint32_t worker) {
+	parallel_run_t *run = arg;
+	parallel_chunk_t *chunk = &run->chunks[task];
+	parallel_piece_t *piece = &chunk->head;
+	scan_structure_t masks;
+	uint64_t escape_carry = chunk->escaped;
+	uint64_t in_string = chunk->in_string ? ~(uint64_t)0 : 0;
+	uint64_t inside;
+	uint64_t structure;
+	uint64_t bit;
+
+	(void)worker;
+	for (uint8_t *block = chunk->start; block < chunk->end; block += SCAN_BLOCK_SIZE) {
+		LoadBlock(block, chunk->end, &masks);
+		inside = PrefixXor(masks.quote & ~FindEscaped(masks.backslash, &escape_carry)) ^ in_string;
+		in_string = (inside >> 63) ? ~(uint64_t)0 : 0;
+		if (chunk->split != NULL) {
+			masks.comma = 0;
+		}
+		structure = (masks.comma | masks.object_open | masks.array_open | masks.close) & ~inside;
+		while (structure != 0) {
+			bit = structure & (~structure + 1);
+			if (masks.comma & bit) {
+				if (chunk->split == NULL) {
+					chunk->split = block + CountTrailingZeros(bit);
+					piece = &chunk->tail;
+				}
+			} else if (masks.object_open & bit) {
+				AddOpen(piece, true);
+			} else if (masks.array_open & bit) {
+				AddOpen(piece, false);
+			} else {
+				AddClose(piece);
+			}
+			structure ^= bit;
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  FindSegments
+*
+* Description:
+* Join the bracket sums of the chunks in order to find the objects and arrays
+* open at the comma each chunk was split at, and cut the text into segments
+* at those commas.
+*
+* Parameters:
+* run		parallel_run_t *	lint the segments are found for
+*
+* Return Value:	None.
+*
+* Notes:
+* A sum that can not belong to valid text, such as a close with nothing open
+* or a comma outside of any object or array, ends the cutting.  The last
+* segment then runs to the end of the text.
+*
+******************************************************************************/
+static void FindSegments(parallel_run_t *run) {
+	uint32_t depth = 0;
+	uint64_t stack[PARALLEL_STACK_WORDS] = { 0 };
+	parallel_chunk_t *chunk;
+	parallel_segment_t *segment = &run->segments[0];
+	bool valid = true;
+
+	segment->start = run->text;
+	run->segment_count = 1;
+	for (uint32_t index = 0; valid && index < run->chunk_count; index++) {
+		chunk = &run->chunks[index];
+		valid = ApplyPiece(&chunk->head, &depth, stack, run->max_depth);
+		if (valid && chunk->split != NULL) {
+			valid = (depth > 0);
+			if (valid) {
+				segment->end = chunk->split + 1;
+				segment = &run->segments[run->segment_count++];
+				segment->start = chunk->split + 1;
+				segment->depth = depth;
+				memcpy(segment->stack, stack, sizeof(stack));
+				valid = ApplyPiece(&chunk->tail, &depth, stack, run->max_depth);
+			}
+		}
+	}
+	segment->end = run->end;
+}
+
+/******************************************************************************
+* Function Name:  LintSegment
+*
+* Description:
+* Lint one segment of the text, started in the state found by FindSegments().
+*
+* Parameters:
+* arg		void *		pointer to the parallel_run_t of the lint
+* task		uint32_t	number of the segment
+* worker	uint32_t	number of the worker running the task, not used
+*
+* Return Value:	None.
+*
+* Notes:
+* Every segment but the last ends after a comma, so its result is
+* RESULT_JSON_LINT_INCOMPLETE unless an error is found.
+*
+******************************************************************************/
+static void LintSegment(void *arg, uint32_t task, uint32_t worker) {
+	parallel_run_t *run = arg;
+	parallel_segment_t *segment = &run->segments[task];
+
+	(void)worker;
+	LintJSONInit(&segment->ctx);
+	segment->ctx.max_depth = run->max_depth;
+	segment->ctx.max_length = run->options->max_length;
+	segment->ctx.max_string = run->options->max_string;
+	segment->ctx.max_number = run->options->max_number;
+	if (task == 0) {
+		LintJSONBegin(&segment->ctx);
+	} else {
+		LintJSONBeginMember(&segment->ctx, segment->start - run->text, segment->depth, segment->stack);
+	}
+	segment->result = LintJSONFeed(&segment->ctx, segment->start, segment->end - segment->start);
+	if (task + 1 == run->segment_count && segment->result == RESULT_JSON_LINT_INCOMPLETE) {
+		segment->result = LintJSONFinish(&segment->ctx);
+	}
+}
+
+/******************************************************************************
+* Function Name:  JoinSegments
+*
+* Description:
+* Check the segments in order and give the result of the whole text.
+*
+* Parameters:
+* run		parallel_run_t *		lint of the segments
+* ctx		json_lint_context_t *	context to give the result in
+*
+* Return Value:
+* json_lint_result_t	RESULT_JSON_LINT_SUCCESS or RESULT_JSON_LINT_INVALID
+*
+* Notes:
+* Stops at the first segment that is invalid, the last segment, or a segment
+* that did not end in the state the next one was started in.  Text after a
+* segment of the last kind is linted here by continuing its context.
+*
+******************************************************************************/
+static json_lint_result_t JoinSegments(parallel_run_t *run, json_lint_context_t *ctx) {
+	json_lint_result_t result = RESULT_JSON_LINT_INVALID;
+	json_lint_stats_t stats = { 0 };
+	parallel_segment_t *segment = NULL;
+	bool joined = true;
+
+	for (uint32_t index = 0; joined && index < run->segment_count; index++) {
+		segment = &run->segments[index];
+		if (index + 1 == run->segment_count || segment->result != RESULT_JSON_LINT_INCOMPLETE) {
+			result = segment->result;
+			joined = false;
+		} else if (!SameState(&segment->ctx, &run->segments[index + 1])) {
+			result = LintJSONFeed(&segment->ctx, segment->end, run->end - segment->end);
+			if (result == RESULT_JSON_LINT_INCOMPLETE) {
+				result = LintJSONFinish(&segment->ctx);
+			}
+			joined = false;
+		} else {
+			LintJSONAddStats(&stats, &segment->ctx.stats);
+		}
+	}
+
+	LintJSONAddStats(&stats, &segment->ctx.stats);
+	*ctx = segment->ctx;
+	ctx->stats = stats;
+	if (result == RESULT_JSON_LINT_INVALID) {
+		ctx->ptr_invalid_json = run->text + ctx->offset_invalid_json;
+	}
+
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  LoadBlock
+*
+* Description:
+* Find the masks of the next block of a chunk.
+*
+* Parameters:
+* block		uint8_t *				pointer to the first byte of the block
+* end		uint8_t *				pointer to one past the last byte of the chunk
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:
+* A block cut by the end of the chunk is copied and padded with zeros, which
+* are not in any mask, so nothing past the end is read.
+*
+******************************************************************************/
+static void LoadBlock(uint8_t *block, uint8_t *end, scan_structure_t *masks) {
+	uint8_t padded[SCAN_BLOCK_SIZE] = { 0 };
+
+	if (end - block >= SCAN_BLOCK_SIZE) {
+		ScanStructure(block, masks);
+	} else {
+		memcpy(padded, block, end - block);
+		ScanStructure(padded, masks);
+	}
+}
+
+/******************************************************************************
+* Function Name:  FindEscaped
+*
+* Description:
+* Find the bytes of a block that are escaped, the bytes after each run of an
+* odd number of backslashes.
+*
+* Parameters:
+* backslash		uint64_t		mask of the backslashes of the block
+* escape_carry	uint64_t *		1 if the first byte of the block is escaped,
+*								set for the next block
+*
+* Return Value:
+* uint64_t		mask of the escaped bytes
+*
+* Notes:
+* Adding the first backslash of each run that starts on an odd bit to the
+* backslashes carries through the run and lands on the byte after it.  Runs
+* that start on an even bit are found the same way, and the length of a run
+* is odd when its start and the byte after it are on bits of different
+* parity.
+*
+******************************************************************************/
+static uint64_t FindEscaped(uint64_t backslash, uint64_t *escape_carry) {
+	const uint64_t even_bits = 0x5555555555555555ULL;
+	uint64_t starts = backslash & ~(backslash << 1);
+	uint64_t even_start_mask = even_bits ^ *escape_carry;
+	uint64_t even_starts = starts & even_start_mask;
+	uint64_t odd_starts = starts & ~even_start_mask;
+	uint64_t even_carries = backslash + even_starts;
+	uint64_t odd_carries = backslash + odd_starts;
+	uint64_t carry_out = (odd_carries < backslash);
+
+	odd_carries |= *escape_carry;
+	*escape_carry = carry_out;
+
+	return ((even_carries & ~backslash & ~even_bits) | (odd_carries & ~backslash & even_bits));
+}
+
+/******************************************************************************
+* Function Name:  PrefixXor
+*
+* Description:
+* Set each bit of a mask to the xor of it and all lower bits.
+*
+* Parameters:
+* mask		uint64_t		mask to xor
+*
+* Return Value:
+* uint64_t		prefix xor of the mask
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint64_t PrefixXor(uint64_t mask) {
+	mask ^= mask << 1;
+	mask ^= mask << 2;
+	mask ^= mask << 4;
+	mask ^= mask << 8;
+	mask ^= mask << 16;
+	mask ^= mask << 32;
+
+	return mask;
+}
+
+/******************************************************************************
+* Function Name:  AddOpen
+*
+* Description:
+* Add an open of an object or array to the sum of a piece.
+*
+* Parameters:
+* piece		parallel_piece_t *	sum of the piece
+* object	bool				true for an object, false for an array
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void AddOpen(parallel_piece_t *piece, bool object) {
+	if (piece->opens == JSON_LINT_DEPTH_MAX) {
+		piece->too_deep = true;
+	} else {
+		if (object) {
+			piece->stack[piece->opens / 64] |= STACK_BIT(piece->opens);
+		} else {
+			piece->stack[piece->opens / 64] &= ~STACK_BIT(piece->opens);
+		}
+		piece->opens++;
+	}
+}
+
+/******************************************************************************
+* Function Name:  AddClose
+*
+* Description:
+* Add a close of an object or array to the sum of a piece.
+*
+* Parameters:
+* piece		parallel_piece_t *	sum of the piece
+*
+* Return Value:	None.
+*
+* Notes:
+* Whether the close matches the open is left to the lint engine.
+*
+******************************************************************************/
+static void AddClose(parallel_piece_t *piece) {
+	if (piece->opens > 0) {
+		piece->opens--;
+	} else {
+		piece->closes++;
+	}
+}
+
+/******************************************************************************
+* Function Name:  ApplyPiece
+*
+* Description:
+* Apply the sum of a piece to the objects and arrays open before it.
+*
+* Parameters:
+* piece		parallel_piece_t *	sum of the piece
+* depth		uint32_t *			number of objects and arrays open
+* stack		uint64_t *			1 bit per open, 1=object 0=array
+* max_depth	uint32_t			deepest nesting allowed
+*
+* Return Value:
+* bool		false if the piece can not belong to valid text
+*
+* Notes:	None.
+*
+******************************************************************************/
+static bool ApplyPiece(parallel_piece_t *piece, uint32_t *depth, uint64_t *stack, uint32_t max_depth) {
+	bool valid = (!piece->too_deep && piece->closes <= *depth && *depth - piece->closes + piece->opens <= max_depth);
+
+	if (valid) {
+		*depth -= piece->closes;
+		for (uint32_t open = 0; open < piece->opens; open++) {
+			if (piece->stack[open / 64] & STACK_BIT(open)) {
+				stack[*depth / 64] |= STACK_BIT(*depth);
+			} else {
+				stack[*depth / 64] &= ~STACK_BIT(*depth);
+			}
+			(*depth)++;
+		}
+	}
+
+	return valid;
+}
+
+/******************************************************************************
+* Function Name:  SameState
+*
+* Description:
+* Check that a segment ended in the state the next segment was started in.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context the segment was linted with
+* next		parallel_segment_t *	next segment
+*
+* Return Value:
+* bool		true if the states are the same
+*
+* Notes:
+* Bits of the stack above the depth are not used and are not compared.
+*
+******************************************************************************/
+static bool SameState(json_lint_context_t *ctx, parallel_segment_t *next) {
+	json_lint_context_t start;
+	bool same;
+
+	LintJSONInit(&start);
+	LintJSONBeginMember(&start, 0, next->depth, next->stack);
+	same = (ctx->state == start.state && ctx->token == start.token && ctx->depth == start.depth);
+	for (uint32_t level = 0; same && level < ctx->depth; level++) {
+		same = ((ctx->stack[level / 64] ^ start.stack[level / 64]) & STACK_BIT(level)) == 0;
+	}
+
+	return same;
+}
@@ -0,0 +1,50 @@
+/******************************************************************************
+* File Name:  JSONLintParallel.h
+*
+* Description:
+* Lints one large JSON text on several threads.  The result, error, location
+* of the error and counts are the same as linting the text on one thread.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Texts shorter than a few chunks are linted on the calling thread.
+*
+******************************************************************************/
+#ifndef JSON_LINT_PARALLEL_H_
+#define JSON_LINT_PARALLEL_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include "JSONLint.h"
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+json_lint_result_t LintJSONParallel(json_lint_context_t *ctx, uint8_t *ptr_text, size_t length, uint32_t threads);
+
+#endif
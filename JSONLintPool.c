@@ -0,0 +1,317 @@
+/******************************************************************************
+* File Name:  JSONLintPool.c
+*
+* Description:
+* Implementation of the work stealing worker pool.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The tasks of a worker are a range of task numbers packed in one 64 bit word,
+* the first task in the low half and one past the last task in the high half.
+* The owner takes tasks from the front and thieves take from the back, both
+* with a compare and swap of the whole word, so no locks are held.  Tasks are
+* never added once the pool runs, a worker that finds every range empty is
+* done.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "JSONLintPool.h"
+
+#if !defined(JSON_LINT_NO_THREADS)
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define POOL_CACHE_LINE			64
+
+#define RANGE_PACK(first, last)		(((uint64_t)(last) << 32) | (uint32_t)(first))
+#define RANGE_FIRST(range)		((uint32_t)(range))
+#define RANGE_LAST(range)		((uint32_t)((range) >> 32))
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+#if !defined(JSON_LINT_NO_THREADS)
+typedef struct {
+	_Atomic uint64_t range;		//tasks left to the worker
+	uint8_t padding[POOL_CACHE_LINE - sizeof(uint64_t)];	//keeps each range
+								//on its own cache line
+} pool_queue_t;
+
+typedef struct pool_t pool_t;
+
+typedef struct {
+	pool_t *pool;
+	uint32_t worker;			//number of the worker
+	pthread_t thread;
+} pool_worker_t;
+
+struct pool_t {
+	json_lint_pool_task_t function;
+	void *arg;
+	uint32_t worker_count;
+	pool_queue_t queue[JSON_LINT_POOL_WORKERS_MAX];
+	pool_worker_t workers[JSON_LINT_POOL_WORKERS_MAX];
+};
+#endif
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+#if !defined(JSON_LINT_NO_THREADS)
+static void *PoolWorker(void *arg);
+static bool PoolTake(pool_queue_t *queue, uint32_t *task);
+static bool PoolSteal(pool_t *pool, uint32_t worker);
+#endif
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  PoolWorkerCount
+*
+* Description:
+* Find the number of workers to use when the caller does not choose one.
+*
+* Parameters:	None.
+*
+* Return Value:
+* uint32_t		number of processors online, at least 1 and at most
+*				JSON_LINT_POOL_WORKERS_MAX
+*
+* Notes:	None.
+*
+******************************************************************************/
+uint32_t PoolWorkerCount(void) {
+	uint32_t count = 1;
+#if !defined(JSON_LINT_NO_THREADS)
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (online > JSON_LINT_POOL_WORKERS_MAX) {
+		count = JSON_LINT_POOL_WORKERS_MAX;
+	} else if (online > 1) {
+		count = (uint32_t)online;
+	}
+#endif
+
+	return count;
+}
+
+/******************************************************************************
+* Function Name:  PoolRun
+*
+* Description:
+* Run function once for each task number from 0 to task_count - 1 and return
+* when all of them are done.
+*
+* Parameters:
+* worker_count	uint32_t				number of threads to run the tasks on,
+*										0 for PoolWorkerCount()
+* task_count	uint32_t				number of tasks
+* function		json_lint_pool_task_t	function called with arg, the task
+*										number and the number of the worker
+*										running it
+* arg			void *					argument given to function
+*
+* Return Value:	None.
+*
+* Notes:
+* The calling thread is worker 0.  Calls with the same worker number never
+* overlap, so function can keep per worker state indexed by it.  If a thread
+* can not be started its tasks are stolen by the other workers.
+*
+******************************************************************************/
+void PoolRun(uint32_t worker_count, uint32_t task_count, json_lint_pool_task_t function, void *arg) {
+#if defined(JSON_LINT_NO_THREADS)
+	(void)worker_count;
+	for (uint32_t task = 0; task < task_count; task++) {
+		function(arg, task, 0);
+	}
+#else
+	pool_t *pool = NULL;
+	bool started[JSON_LINT_POOL_WORKERS_MAX] = { false };
+
+	if (worker_count == 0) {
+		worker_count = PoolWorkerCount();
+	}
+	if (worker_count > JSON_LINT_POOL_WORKERS_MAX) {
+		worker_count = JSON_LINT_POOL_WORKERS_MAX;
+	}
+	if (worker_count > task_count) {
+		worker_count = (task_count > 0) ? task_count : 1;
+	}
+	if (worker_count > 1) {
+		pool = malloc(sizeof(pool_t));
+	}
+
+	if (pool == NULL) {
+		for (uint32_t task = 0; task < task_count; task++) {
+			function(arg, task, 0);
+		}
+	} else {
+		pool->function = function;
+		pool->arg = arg;
+		pool->worker_count = worker_count;
+		for (uint32_t worker = 0; worker < worker_count; worker++) {
+			atomic_init(&pool->queue[worker].range, RANGE_PACK(
+				(uint64_t)task_count * worker / worker_count,
+				(uint64_t)task_count * (worker + 1) / worker_count));
+			pool->workers[worker].pool = pool;
+			pool->workers[worker].worker = worker;
+		}
+		for (uint32_t worker = 1; worker < worker_count; worker++) {
+			started[worker] = (pthread_create(&pool->workers[worker].thread, NULL,
+				PoolWorker, &pool->workers[worker]) == 0);
+		}
+		PoolWorker(&pool->workers[0]);
+		for (uint32_t worker = 1; worker < worker_count; worker++) {
+			if (started[worker]) {
+				pthread_join(pool->workers[worker].thread, NULL);
+			}
+		}
+		free(pool);
+	}
+#endif
+}
+
+#if !defined(JSON_LINT_NO_THREADS)
+/******************************************************************************
+* Function Name:  PoolWorker
+*
+* Description:
+* Run the tasks of one worker, then steal tasks from the other workers until
+* none are left.
+*
+* Parameters:
+* arg		void *		pointer to the pool_worker_t of the worker
+*
+* Return Value:
+* void *		NULL
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void *PoolWorker(void *arg) {
+	pool_worker_t *worker = arg;
+	pool_t *pool = worker->pool;
+	pool_queue_t *queue = &pool->queue[worker->worker];
+	uint32_t task;
+
+	do {
+		while (PoolTake(queue, &task)) {
+			pool->function(pool->arg, task, worker->worker);
+		}
+	} while (PoolSteal(pool, worker->worker));
+
+	return NULL;
+}
+
+/******************************************************************************
+* Function Name:  PoolTake
+*
+* Description:
+* Take the first task from the front of a worker's range.
+*
+* Parameters:
+* queue		pool_queue_t *		range of the worker
+* task		uint32_t *			task taken
+*
+* Return Value:
+* bool		true if a task was taken, false if the range is empty
+*
+* Notes:	None.
+*
+******************************************************************************/
+static bool PoolTake(pool_queue_t *queue, uint32_t *task) {
+	uint64_t range = atomic_load_explicit(&queue->range, memory_order_relaxed);
+	bool taken = false;
+
+	while (!taken && RANGE_FIRST(range) < RANGE_LAST(range)) {
+		taken = atomic_compare_exchange_weak_explicit(&queue->range, &range,
+			RANGE_PACK(RANGE_FIRST(range) + 1, RANGE_LAST(range)),
+			memory_order_acquire, memory_order_relaxed);
+	}
+	if (taken) {
+		*task = RANGE_FIRST(range);
+	}
+
+	return taken;
+}
+
+/******************************************************************************
+* Function Name:  PoolSteal
+*
+* Description:
+* Move the back half of another worker's range to the empty range of worker.
+*
+* Parameters:
+* pool		pool_t *		pool the workers belong to
+* worker	uint32_t		number of the worker stealing
+*
+* Return Value:
+* bool		true if tasks were stolen, false if every range is empty
+*
+* Notes:
+* Workers are tried in order starting after the thief, which spreads thieves
+* over the other workers.  The thief's own range is empty, so other thieves
+* skip it until the stolen tasks are stored.
+*
+******************************************************************************/
+static bool PoolSteal(pool_t *pool, uint32_t worker) {
+	uint32_t victim = worker;
+	uint64_t range;
+	uint32_t first;
+	uint32_t last;
+	uint32_t split = 0;
+	bool stolen = false;
+
+	for (uint32_t tries = 1; !stolen && tries < pool->worker_count; tries++) {
+		victim = (worker + tries) % pool->worker_count;
+		range = atomic_load_explicit(&pool->queue[victim].range, memory_order_relaxed);
+		while (!stolen && RANGE_FIRST(range) < RANGE_LAST(range)) {
+			first = RANGE_FIRST(range);
+			last = RANGE_LAST(range);
+			split = last - (last - first + 1) / 2;
+			stolen = atomic_compare_exchange_weak_explicit(&pool->queue[victim].range, &range,
+				RANGE_PACK(first, split), memory_order_acquire, memory_order_relaxed);
+		}
+	}
+	if (stolen) {
+		atomic_store_explicit(&pool->queue[worker].range, RANGE_PACK(split, last), memory_order_release);
+	}
+
+	return stolen;
+}
+#endif
@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name:  JSONLintPool.h
+*
+* Description:
+* Worker pool that runs a numbered set of tasks on several threads.  Each
+* worker starts with an equal share of the tasks and steals half of the tasks
+* left to another worker when its share runs out, so uneven tasks still keep
+* every thread busy.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Define JSON_LINT_NO_THREADS when compiling for targets without POSIX threads,
+* the tasks are then run one after another on the calling thread.
+*
+******************************************************************************/
+#ifndef JSON_LINT_POOL_H_
+#define JSON_LINT_POOL_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define JSON_LINT_POOL_WORKERS_MAX		256	//most threads a pool runs
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef void (*json_lint_pool_task_t)(void *arg, uint32_t task, uint32_t worker);
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+uint32_t PoolWorkerCount(void);
+void PoolRun(uint32_t worker_count, uint32_t task_count, json_lint_pool_task_t function, void *arg);
+
+#endif
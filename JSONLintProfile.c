@@ -0,0 +1,359 @@
+/******************************************************************************
+* File Name:  JSONLintProfile.c
+*
+* Description:
+* Implementation of the counters of where a lint spends its work.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The counters of each thread are allocated the first time it counts and are
+* linked into one list, so the counters of threads that have ended, such as
+* the workers of a pool, are still read.  The list only grows; the counters
+* of a thread are plain integers written by that thread alone, so they are
+* read exactly once the lints being profiled have returned.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE		200809L	//clock_gettime() under -std=c11
+#endif
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "JSONLintProfile.h"
+
+#if !defined(JSON_LINT_NO_THREADS)
+#include <pthread.h>
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define NANOSECONDS				1000000000ULL
+
+#if defined(JSON_LINT_NO_THREADS)
+#define PROFILE_LOCK()
+#define PROFILE_UNLOCK()
+#else
+#define PROFILE_LOCK()			pthread_mutex_lock(&profile_lock)
+#define PROFILE_UNLOCK()		pthread_mutex_unlock(&profile_lock)
+#endif
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static void DumpText(char *buffer, size_t size, size_t *used, const char *format, ...);
+static void DumpHistogram(char *buffer, size_t size, size_t *used, const char *name,
+	const uint64_t *histogram);
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+PROFILE_THREAD_LOCAL json_lint_profile_t *profile_thread;
+
+static json_lint_profile_t *profile_list;	//counters of every thread
+#if !defined(JSON_LINT_NO_THREADS)
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;	//held to
+								//change or walk the list
+#endif
+
+static const char *const function_names[PROFILE_JSON_LINT_FUNCTIONS] = {
+	[PROFILE_JSON_LINT_TEXT] = "text",
+	[PROFILE_JSON_LINT_WHITESPACE] = "whitespace",
+	[PROFILE_JSON_LINT_VALUE] = "value",
+	[PROFILE_JSON_LINT_OBJECT] = "object",
+	[PROFILE_JSON_LINT_ARRAY] = "array",
+	[PROFILE_JSON_LINT_STRING] = "string",
+	[PROFILE_JSON_LINT_NUMBER] = "number",
+	[PROFILE_JSON_LINT_LITERAL] = "literal",
+	[PROFILE_JSON_LINT_COMMENT] = "comment",
+};
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  LintJSONProfileGet
+*
+* Description:
+* Add up the counters of every thread that has linted.
+*
+* Parameters:
+* profile	json_lint_profile_t *	counters of all of the threads
+*
+* Return Value:	None.
+*
+* Notes:
+* The deepest nesting is the deepest of any thread.  All counters are 0 when
+* the lint is compiled without JSON_LINT_PROFILE.
+*
+******************************************************************************/
+void LintJSONProfileGet(json_lint_profile_t *profile) {
+	json_lint_profile_t *thread;
+	uint32_t i;
+
+	memset(profile, 0, sizeof(*profile));
+	PROFILE_LOCK();
+	for (thread = profile_list; thread != NULL; thread = thread->next) {
+		for (i = 0; i < PROFILE_JSON_LINT_FUNCTIONS; i++) {
+			profile->functions[i].calls += thread->functions[i].calls;
+			profile->functions[i].bytes += thread->functions[i].bytes;
+		}
+		profile->texts += thread->texts;
+		profile->depth_total += thread->depth_total;
+		if (thread->depth_max > profile->depth_max) {
+			profile->depth_max = thread->depth_max;
+		}
+		for (i = 0; i < PROFILE_JSON_LINT_BUCKETS; i++) {
+			profile->strings[i] += thread->strings[i];
+			profile->numbers[i] += thread->numbers[i];
+			profile->latency[i] += thread->latency[i];
+		}
+	}
+	PROFILE_UNLOCK();
+}
+
+/******************************************************************************
+* Function Name:  LintJSONProfileReset
+*
+* Description:
+* Set the counters of every thread back to 0.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* Call when no thread is linting, a count made during the reset may be kept.
+*
+******************************************************************************/
+void LintJSONProfileReset(void) {
+	json_lint_profile_t *thread;
+	json_lint_profile_t *next;
+
+	PROFILE_LOCK();
+	for (thread = profile_list; thread != NULL; thread = next) {
+		next = thread->next;
+		memset(thread, 0, sizeof(*thread));
+		thread->next = next;
+	}
+	PROFILE_UNLOCK();
+}
+
+/******************************************************************************
+* Function Name:  LintJSONProfileDump
+*
+* Description:
+* Write counters as one line of JSON, e.g.
+* {"texts":2,"depth_max":3,"depth_mean":2.50,"functions":{"text":{"calls":2,
+* "bytes":90},...},"strings":[0,4,9],"numbers":[0,12],"latency_ns":[...]}
+*
+* Parameters:
+* profile	const json_lint_profile_t *	counters from LintJSONProfileGet()
+* buffer	char *			buffer for the text, may be NULL if size is 0
+* size		size_t			bytes of the buffer
+*
+* Return Value:
+* size_t		length of the whole text, without its null terminator
+*
+* Notes:
+* As with snprintf(), the text is cut to fit the buffer and is always null
+* terminated when size is not 0, so a return of size or more means the buffer
+* was too small.  Element n of a histogram counts values of 2^(n-1) to 2^n - 1,
+* element 0 counts 0, and each histogram ends at its last bucket that is not 0.
+*
+******************************************************************************/
+size_t LintJSONProfileDump(const json_lint_profile_t *profile, char *buffer, size_t size) {
+	size_t used = 0;
+	uint32_t i;
+
+	DumpText(buffer, size, &used, "{\"texts\":%llu,\"depth_max\":%llu,\"depth_mean\":%.2f,\"functions\":{",
+		(unsigned long long)profile->texts, (unsigned long long)profile->depth_max,
+		profile->texts != 0 ? (double)profile->depth_total / (double)profile->texts : 0.0);
+	for (i = 0; i < PROFILE_JSON_LINT_FUNCTIONS; i++) {
+		DumpText(buffer, size, &used, "%s\"%s\":{\"calls\":%llu,\"bytes\":%llu}", i != 0 ? "," : "",
+			function_names[i], (unsigned long long)profile->functions[i].calls,
+			(unsigned long long)profile->functions[i].bytes);
+	}
+	DumpText(buffer, size, &used, "}");
+	DumpHistogram(buffer, size, &used, "strings", profile->strings);
+	DumpHistogram(buffer, size, &used, "numbers", profile->numbers);
+	DumpHistogram(buffer, size, &used, "latency_ns", profile->latency);
+	DumpText(buffer, size, &used, "}");
+
+	return used;
+}
+
+/******************************************************************************
+* Function Name:  ProfileRegister
+*
+* Description:
+* Allocate the counters of the calling thread and link them into the list.
+*
+* Parameters:	None.
+*
+* Return Value:
+* json_lint_profile_t *		counters of the thread, or NULL if there is no
+*							memory for them
+*
+* Notes:
+* The counters are not freed when the thread ends, their counts are kept.
+*
+******************************************************************************/
+json_lint_profile_t *ProfileRegister(void) {
+	json_lint_profile_t *profile = calloc(1, sizeof(*profile));
+
+	if (profile != NULL) {
+		PROFILE_LOCK();
+		profile->next = profile_list;
+		profile_list = profile;
+		PROFILE_UNLOCK();
+		profile_thread = profile;
+	}
+
+	return profile;
+}
+
+/******************************************************************************
+* Function Name:  ProfileBucket
+*
+* Description:
+* Find the histogram bucket of a value, the number of bits it needs.
+*
+* Parameters:
+* value		uint64_t		value to count
+*
+* Return Value:
+* uint32_t		bucket, values past the last bucket are counted in it
+*
+* Notes:	None.
+*
+******************************************************************************/
+uint32_t ProfileBucket(uint64_t value) {
+	uint32_t bucket = 0;
+
+	while (value != 0 && bucket < PROFILE_JSON_LINT_BUCKETS - 1) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+/******************************************************************************
+* Function Name:  ProfileClock
+*
+* Description:
+* Read a monotonic clock.
+*
+* Parameters:	None.
+*
+* Return Value:
+* uint64_t		nanoseconds from an arbitrary start, never 0
+*
+* Notes:
+* 0 is kept to mean a text that is not timed.
+*
+******************************************************************************/
+uint64_t ProfileClock(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * NANOSECONDS + (uint64_t)now.tv_nsec + 1;
+}
+
+/******************************************************************************
+* Function Name:  DumpText
+*
+* Description:
+* Append formatted text to the dump, cut to fit the buffer.
+*
+* Parameters:
+* buffer	char *			buffer of the dump
+* size		size_t			bytes of the buffer
+* used		size_t *		length of the dump so far, the text is added to it
+* format	const char *	printf() format of the text
+* ...						values of the format
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void DumpText(char *buffer, size_t size, size_t *used, const char *format, ...) {
+	va_list arguments;
+	int length;
+
+	va_start(arguments, format);
+	if (*used < size) {
+		length = vsnprintf(buffer + *used, size - *used, format, arguments);
+	} else {
+		length = vsnprintf(NULL, 0, format, arguments);
+	}
+	va_end(arguments);
+	if (length > 0) {
+		*used += (size_t)length;
+	}
+}
+
+/******************************************************************************
+* Function Name:  DumpHistogram
+*
+* Description:
+* Append a histogram to the dump as a member holding an array of counts.
+*
+* Parameters:
+* buffer	char *			buffer of the dump
+* size		size_t			bytes of the buffer
+* used		size_t *		length of the dump so far, the text is added to it
+* name		const char *	name of the member
+* histogram	const uint64_t *	PROFILE_JSON_LINT_BUCKETS counts
+*
+* Return Value:	None.
+*
+* Notes:
+* The array stops at the last count that is not 0.
+*
+******************************************************************************/
+static void DumpHistogram(char *buffer, size_t size, size_t *used, const char *name,
+	const uint64_t *histogram) {
+	uint32_t buckets = PROFILE_JSON_LINT_BUCKETS;
+	uint32_t i;
+
+	while (buckets > 0 && histogram[buckets - 1] == 0) {
+		buckets--;
+	}
+	DumpText(buffer, size, used, ",\"%s\":[", name);
+	for (i = 0; i < buckets; i++) {
+		DumpText(buffer, size, used, "%s%llu", i != 0 ? "," : "", (unsigned long long)histogram[i]);
+	}
+	DumpText(buffer, size, used, "]");
+}
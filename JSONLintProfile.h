@@ -0,0 +1,226 @@
+/******************************************************************************
+* File Name:  JSONLintProfile.h
+*
+* Description:
+* Counters of where a lint spends its work: the calls and bytes of each
+* processing function, the nesting of the texts, and histograms of the lengths
+* of strings and numbers and of the time to lint a text.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* The counters are only kept when the lint is compiled with JSON_LINT_PROFILE
+* defined, otherwise the hooks in the lint are empty and the functions below
+* give counters of 0.  Each thread counts into its own counters, which are
+* added together when they are read.  Define JSON_LINT_NO_THREADS when
+* compiling for targets without POSIX threads.
+*
+******************************************************************************/
+#ifndef JSON_LINT_PROFILE_H_
+#define JSON_LINT_PROFILE_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define PROFILE_JSON_LINT_BUCKETS	40	//bucket n counts values of 2^(n-1) to
+										//2^n - 1, bucket 0 counts 0
+
+#if defined(JSON_LINT_NO_THREADS)
+#define PROFILE_THREAD_LOCAL
+#elif defined(_MSC_VER)
+#define PROFILE_THREAD_LOCAL	__declspec(thread)
+#else
+#define PROFILE_THREAD_LOCAL	_Thread_local
+#endif
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef enum {
+	PROFILE_JSON_LINT_TEXT,				//ProcessText(), once for each chunk
+	PROFILE_JSON_LINT_WHITESPACE,		//ProcessWhitespace()
+	PROFILE_JSON_LINT_VALUE,			//ProcessValue()
+	PROFILE_JSON_LINT_OBJECT,			//ProcessObject()
+	PROFILE_JSON_LINT_ARRAY,			//ProcessArray()
+	PROFILE_JSON_LINT_STRING,			//ProcessString(), strings and keys
+	PROFILE_JSON_LINT_NUMBER,			//ProcessNumber()
+	PROFILE_JSON_LINT_LITERAL,			//ProcessLiteral(), names cut by a chunk
+	PROFILE_JSON_LINT_COMMENT,			//SkipComment()
+	PROFILE_JSON_LINT_FUNCTIONS,		//number of functions counted
+} json_lint_profile_function_t;
+
+typedef struct {
+	uint64_t calls;				//times the function was called
+	uint64_t bytes;				//bytes of text it moved past, including the
+								//bytes of the functions it called
+} json_lint_profile_count_t;
+
+typedef struct json_lint_profile_t {
+	json_lint_profile_count_t functions[PROFILE_JSON_LINT_FUNCTIONS];
+	uint64_t texts;				//texts finished, valid or not
+	uint64_t depth_max;			//deepest nesting of any text
+	uint64_t depth_total;		//deepest nesting of each text added up, the
+								//mean is depth_total / texts
+	uint64_t strings[PROFILE_JSON_LINT_BUCKETS];	//bytes between the quotes
+	uint64_t numbers[PROFILE_JSON_LINT_BUCKETS];	//bytes of each number
+	uint64_t latency[PROFILE_JSON_LINT_BUCKETS];	//nanoseconds of each text
+								//linted in one call
+	struct json_lint_profile_t *next;	//counters of the next thread
+} json_lint_profile_t;
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+extern PROFILE_THREAD_LOCAL json_lint_profile_t *profile_thread;	//counters of
+								//the calling thread, NULL until it first counts
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+void LintJSONProfileGet(json_lint_profile_t *profile);
+void LintJSONProfileReset(void);
+size_t LintJSONProfileDump(const json_lint_profile_t *profile, char *buffer, size_t size);
+json_lint_profile_t *ProfileRegister(void);
+uint32_t ProfileBucket(uint64_t value);
+uint64_t ProfileClock(void);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  ProfileThread
+*
+* Description:
+* Give the counters of the calling thread.
+*
+* Parameters:	None.
+*
+* Return Value:
+* json_lint_profile_t *		counters of the thread, or NULL if there is no
+*							memory for them
+*
+* Notes:
+* The counters are allocated and registered the first time a thread counts.
+*
+******************************************************************************/
+static inline json_lint_profile_t *ProfileThread(void) {
+	json_lint_profile_t *profile = profile_thread;
+
+	if (profile == NULL) {
+		profile = ProfileRegister();
+	}
+
+	return profile;
+}
+
+/******************************************************************************
+* Function Name:  ProfileCall
+*
+* Description:
+* Count a call of a processing function and the bytes it moved past.
+*
+* Parameters:
+* function	json_lint_profile_function_t	function called
+* bytes		size_t			bytes of text moved past
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline void ProfileCall(json_lint_profile_function_t function, size_t bytes) {
+	json_lint_profile_t *profile = ProfileThread();
+
+	if (profile != NULL) {
+		profile->functions[function].calls++;
+		profile->functions[function].bytes += bytes;
+	}
+}
+
+/******************************************************************************
+* Function Name:  ProfileLength
+*
+* Description:
+* Count the length of a string or number in its histogram.
+*
+* Parameters:
+* function	json_lint_profile_function_t	PROFILE_JSON_LINT_STRING or
+*											PROFILE_JSON_LINT_NUMBER
+* length	uint64_t		bytes of the string or number
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline void ProfileLength(json_lint_profile_function_t function, uint64_t length) {
+	json_lint_profile_t *profile = ProfileThread();
+
+	if (profile != NULL) {
+		if (function == PROFILE_JSON_LINT_NUMBER) {
+			profile->numbers[ProfileBucket(length)]++;
+		} else {
+			profile->strings[ProfileBucket(length)]++;
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  ProfileText
+*
+* Description:
+* Count a finished text, its deepest nesting and the time taken to lint it.
+*
+* Parameters:
+* depth		uint32_t		deepest nesting of the text
+* start		uint64_t		ProfileClock() when the lint started, 0 when the
+*							text was given in chunks and is not timed
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline void ProfileText(uint32_t depth, uint64_t start) {
+	json_lint_profile_t *profile = ProfileThread();
+
+	if (profile != NULL) {
+		profile->texts++;
+		profile->depth_total += depth;
+		if (depth > profile->depth_max) {
+			profile->depth_max = depth;
+		}
+		if (start != 0) {
+			profile->latency[ProfileBucket(ProfileClock() - start)]++;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,1542 @@
+/******************************************************************************
+* File Name:  JSONLintScan.c
+*
+* Description:
+* Implementation of the scanning kernels that skip whitespace and string text
+* for the JSON lint, and the choice of the kernel the processor runs best.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* Each vector kernel builds a bit mask with one bit per byte of the block that
+* stops the run, the position of the lowest set bit is the end of the run.  The
+* bytes left over at the end of the text, fewer than a block, are scanned one
+* at a time so nothing past the end pointer is loaded.  The AVX-512 kernel
+* loads them with the bytes past the end masked off instead.
+*
+* On x86 every kernel is built into one object, each function with the target
+* of its instruction set, so the build does not need -mavx2 or -msse4.2.  The
+* kernel is chosen from cpuid the first time a scan is made, and
+* JSON_LINT_KERNEL in the environment can name a slower one to use.
+*
+******************************************************************************/
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "JSONLintScan.h"
+
+#if (defined(__GNUC__) || defined(_MSC_VER)) && \
+	(defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define SCAN_DISPATCH
+#include <immintrin.h>
+#if !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define SCAN_WHITESPACE			0x01	//space, line feed, carriage return, tab
+#define SCAN_STRING_STOP		0x02	//quote, backslash or control character
+
+#define CHAR_CONTROL_MAX		0x1F
+#define CHAR_ASCII_END			0x80	//first byte that is not ASCII
+
+#define UTF8_TAIL_1			1	//1 more byte of 0x80 to 0xBF
+#define UTF8_TAIL_2			2	//2 more bytes of 0x80 to 0xBF
+#define UTF8_TAIL_3			3	//3 more bytes of 0x80 to 0xBF
+#define UTF8_E0				4	//0xA0 to 0xBF, then 1 more (not overlong)
+#define UTF8_ED				5	//0x80 to 0x9F, then 1 more (not a surrogate)
+#define UTF8_F0				6	//0x90 to 0xBF, then 2 more (not overlong)
+#define UTF8_F4				7	//0x80 to 0x8F, then 2 more (not past U+10FFFF)
+
+//bits of the errors found by the vector kernels from a byte and the byte
+//before it, a byte is valid when no bit is in all 3 lookups
+#define UTF8_TOO_SHORT			0x01	//lead byte not followed by a continuation
+#define UTF8_TOO_LONG			0x02	//continuation after ASCII
+#define UTF8_OVERLONG_3			0x04	//E0 80..9F
+#define UTF8_TOO_LARGE			0x08	//F4 90..BF, F5..FF
+#define UTF8_SURROGATE			0x10	//ED A0..BF
+#define UTF8_OVERLONG_2			0x20	//C0..C1
+#define UTF8_TOO_LARGE_1000		0x40	//F5..FF 80..8F
+#define UTF8_OVERLONG_4			0x40	//F0 80..8F
+#define UTF8_TWO_CONTINUATIONS		0x80	//continuation after continuation
+#define UTF8_CARRY			(UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTINUATIONS)
+
+//lookup by the high nibble of the byte before
+#define UTF8_BYTE_1_HIGH \
+	(char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, \
+	(char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, (char)UTF8_TOO_LONG, \
+	(char)UTF8_TWO_CONTINUATIONS, (char)UTF8_TWO_CONTINUATIONS, (char)UTF8_TWO_CONTINUATIONS, (char)UTF8_TWO_CONTINUATIONS, \
+	(char)(UTF8_TOO_SHORT | UTF8_OVERLONG_2), \
+	(char)UTF8_TOO_SHORT, \
+	(char)(UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE), \
+	(char)(UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4)
+
+//lookup by the low nibble of the byte before
+#define UTF8_BYTE_1_LOW \
+	(char)(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4), \
+	(char)(UTF8_CARRY | UTF8_OVERLONG_2), \
+	(char)UTF8_CARRY, \
+	(char)UTF8_CARRY, \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000), \
+	(char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000)
+
+//lookup by the high nibble of the byte
+#define UTF8_BYTE_2_HIGH \
+	(char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, \
+	(char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, \
+	(char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4), \
+	(char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE), \
+	(char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE), \
+	(char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTINUATIONS | UTF8_SURROGATE | UTF8_TOO_LARGE), \
+	(char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT, (char)UTF8_TOO_SHORT
+
+#define SCAN_WHITESPACE_PROBE		8	//bytes checked one at a time before a vector loop
+
+#define SCAN_KERNEL_ENV			"JSON_LINT_KERNEL"	//environment variable that
+												//names the kernel to use
+
+//instruction sets of each kernel, MSVC allows any intrinsic in any function
+#if defined(_MSC_VER)
+#define SCAN_TARGET_SSE42
+#define SCAN_TARGET_AVX2
+#define SCAN_TARGET_AVX512
+#else
+#define SCAN_TARGET_SSE42		__attribute__((target("sse4.2,popcnt")))
+#define SCAN_TARGET_AVX2		__attribute__((target("avx2,bmi,popcnt")))
+#define SCAN_TARGET_AVX512		__attribute__((target("avx512f,avx512bw,avx2,bmi,popcnt")))
+#endif
+
+#define CPUID_1_ECX_SSE42		(1u << 20)
+#define CPUID_1_ECX_POPCNT		(1u << 23)
+#define CPUID_1_ECX_OSXSAVE		(1u << 27)	//xgetbv gives the state the OS saves
+#define CPUID_1_ECX_AVX			(1u << 28)
+#define CPUID_7_EBX_BMI1		(1u << 3)
+#define CPUID_7_EBX_AVX2		(1u << 5)
+#define CPUID_7_EBX_AVX512F		(1u << 16)
+#define CPUID_7_EBX_AVX512BW	(1u << 30)
+#define XCR0_AVX				0x06	//XMM and YMM registers saved
+#define XCR0_AVX512				0xE6	//and the mask and upper ZMM registers
+
+#define SCAN_MASK_64(bytes)		(((bytes) >= 64) ? UINT64_MAX : (((uint64_t)1 << (bytes)) - 1))
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	const char *name;			//name given by ScanKernel()
+	uint8_t *(*whitespace)(uint8_t *index, uint8_t *end);
+	uint8_t *(*string)(uint8_t *index, uint8_t *end);
+	size_t (*lines)(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+	uint8_t *(*utf8)(uint8_t *index, uint8_t *end, bool *stopped);	//whole
+								//blocks of characters, the rest is checked
+								//a byte at a time
+	void (*structure)(const uint8_t *block, scan_structure_t *masks);
+} scan_kernel_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+static inline const scan_kernel_t *KernelInUse(void);
+static const scan_kernel_t *ScanSelect(void);
+static uint32_t CPUKernels(void);
+static uint8_t *WhitespaceBytes(uint8_t *index, uint8_t *end);
+static uint8_t *StringBytes(uint8_t *index, uint8_t *end);
+static size_t LinesBytes(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+static uint8_t *UTF8Blocks(uint8_t *index, uint8_t *end, bool *stopped);
+static void StructureBytes(const uint8_t *block, scan_structure_t *masks);
+static uint8_t *ScanUTF8Bytes(uint8_t *index, uint8_t *end, uint8_t *state, bool character_only);
+static uint8_t UTF8Lead(uint8_t byte);
+#if defined(SCAN_DISPATCH)
+static void CPUID(uint32_t leaf, uint32_t subleaf, uint32_t *registers);
+static uint64_t XGetBV(void);
+static uint32_t UTF8Cut(uint8_t *block_end);
+SCAN_TARGET_SSE42 static uint8_t *WhitespaceSSE42(uint8_t *index, uint8_t *end);
+SCAN_TARGET_SSE42 static uint8_t *StringSSE42(uint8_t *index, uint8_t *end);
+SCAN_TARGET_SSE42 static size_t LinesSSE42(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+SCAN_TARGET_SSE42 static uint8_t *UTF8SSE42(uint8_t *index, uint8_t *end, bool *stopped);
+SCAN_TARGET_SSE42 static inline __m128i UTF8Errors128(__m128i text);
+SCAN_TARGET_SSE42 static void StructureSSE42(const uint8_t *block, scan_structure_t *masks);
+SCAN_TARGET_AVX2 static uint8_t *WhitespaceAVX2(uint8_t *index, uint8_t *end);
+SCAN_TARGET_AVX2 static uint8_t *StringAVX2(uint8_t *index, uint8_t *end);
+SCAN_TARGET_AVX2 static size_t LinesAVX2(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+SCAN_TARGET_AVX2 static uint8_t *UTF8AVX2(uint8_t *index, uint8_t *end, bool *stopped);
+SCAN_TARGET_AVX2 static inline __m256i UTF8Errors256(__m256i text);
+SCAN_TARGET_AVX2 static void StructureAVX2(const uint8_t *block, scan_structure_t *masks);
+SCAN_TARGET_AVX512 static uint8_t *WhitespaceAVX512(uint8_t *index, uint8_t *end);
+SCAN_TARGET_AVX512 static uint8_t *StringAVX512(uint8_t *index, uint8_t *end);
+SCAN_TARGET_AVX512 static size_t LinesAVX512(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+SCAN_TARGET_AVX512 static void StructureAVX512(const uint8_t *block, scan_structure_t *masks);
+#endif
+
+/******************************************************************************
+* Variables
+******************************************************************************/
+//range of the next byte and the state after it, indexed by the UTF8_ state
+static const uint8_t utf8_low[8] = { 0, 0x80, 0x80, 0x80, 0xA0, 0x80, 0x90, 0x80 };
+static const uint8_t utf8_high[8] = { 0, 0xBF, 0xBF, 0xBF, 0xBF, 0x9F, 0xBF, 0x8F };
+static const uint8_t utf8_next[8] = { 0, SCAN_UTF8_ACCEPT, UTF8_TAIL_1, UTF8_TAIL_2,
+	UTF8_TAIL_1, UTF8_TAIL_1, UTF8_TAIL_2, UTF8_TAIL_2 };
+
+static const uint8_t scan_class[256] = {
+	[0x00] = SCAN_STRING_STOP, [0x01] = SCAN_STRING_STOP,
+	[0x02] = SCAN_STRING_STOP, [0x03] = SCAN_STRING_STOP,
+	[0x04] = SCAN_STRING_STOP, [0x05] = SCAN_STRING_STOP,
+	[0x06] = SCAN_STRING_STOP, [0x07] = SCAN_STRING_STOP,
+	[0x08] = SCAN_STRING_STOP, [0x09] = SCAN_STRING_STOP | SCAN_WHITESPACE,
+	[0x0A] = SCAN_STRING_STOP | SCAN_WHITESPACE, [0x0B] = SCAN_STRING_STOP,
+	[0x0C] = SCAN_STRING_STOP, [0x0D] = SCAN_STRING_STOP | SCAN_WHITESPACE,
+	[0x0E] = SCAN_STRING_STOP, [0x0F] = SCAN_STRING_STOP,
+	[0x10] = SCAN_STRING_STOP, [0x11] = SCAN_STRING_STOP,
+	[0x12] = SCAN_STRING_STOP, [0x13] = SCAN_STRING_STOP,
+	[0x14] = SCAN_STRING_STOP, [0x15] = SCAN_STRING_STOP,
+	[0x16] = SCAN_STRING_STOP, [0x17] = SCAN_STRING_STOP,
+	[0x18] = SCAN_STRING_STOP, [0x19] = SCAN_STRING_STOP,
+	[0x1A] = SCAN_STRING_STOP, [0x1B] = SCAN_STRING_STOP,
+	[0x1C] = SCAN_STRING_STOP, [0x1D] = SCAN_STRING_STOP,
+	[0x1E] = SCAN_STRING_STOP, [0x1F] = SCAN_STRING_STOP,
+	[' '] = SCAN_WHITESPACE,
+	['"'] = SCAN_STRING_STOP,
+	['\\'] = SCAN_STRING_STOP,
+};
+
+//kernels from the slowest to the fastest, the first CPUKernels() of them run
+//on this processor
+static const scan_kernel_t scan_kernels[] = {
+	{ "scalar", WhitespaceBytes, StringBytes, LinesBytes, UTF8Blocks, StructureBytes },
+#if defined(SCAN_DISPATCH)
+	{ "sse4.2", WhitespaceSSE42, StringSSE42, LinesSSE42, UTF8SSE42, StructureSSE42 },
+	{ "avx2", WhitespaceAVX2, StringAVX2, LinesAVX2, UTF8AVX2, StructureAVX2 },
+	{ "avx512", WhitespaceAVX512, StringAVX512, LinesAVX512, UTF8AVX2, StructureAVX512 },
+#endif
+};
+
+static _Atomic(const scan_kernel_t *) scan_kernel = NULL;	//kernel in use, NULL
+								//until the first scan
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  ScanKernel
+*
+* Description:
+* Give the name of the kernel the scanning functions use.
+*
+* Parameters:	None.
+*
+* Return Value:
+* const char *		"avx512", "avx2", "sse4.2" or "scalar"
+*
+* Notes:
+* The kernel is chosen if no scan has been made yet.
+*
+******************************************************************************/
+const char *ScanKernel(void) {
+	return KernelInUse()->name;
+}
+
+/******************************************************************************
+* Function Name:  ScanUseKernel
+*
+* Description:
+* Choose the kernel the scanning functions use.
+*
+* Parameters:
+* name		const char *	name of the kernel as given by ScanKernel(), or
+*							NULL for the one named by JSON_LINT_KERNEL in the
+*							environment, or else the fastest
+*
+* Return Value:
+* bool		true if the kernel is used, false if there is no kernel of that
+*			name the processor can run
+*
+* Notes:
+* No other thread may be scanning while the kernel is changed.  A name in the
+* environment that can not be used is ignored.
+*
+******************************************************************************/
+bool ScanUseKernel(const char *name) {
+	uint32_t count = CPUKernels();
+	uint32_t kernel = count;	//none
+	const char *wanted = (name != NULL) ? name : getenv(SCAN_KERNEL_ENV);
+
+	for (uint32_t index = 0; index < count && wanted != NULL; index++) {
+		if (strcmp(wanted, scan_kernels[index].name) == 0) {
+			kernel = index;
+		}
+	}
+	if (kernel == count && name == NULL) {
+		kernel = count - 1;
+	}
+	if (kernel < count) {
+		atomic_store_explicit(&scan_kernel, &scan_kernels[kernel], memory_order_relaxed);
+	}
+
+	return (kernel < count);
+}
+
+/******************************************************************************
+* Function Name:  ScanWhitespace
+*
+* Description:
+* Find the first byte that is not whitespace (space, line feed, carriage
+* return, tab).
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that is not whitespace, or end
+*
+* Notes:
+* Most runs of whitespace are short, a single space or a line feed and an
+* indent, so the first bytes are checked one at a time before calling the
+* kernel.
+*
+******************************************************************************/
+uint8_t *ScanWhitespace(uint8_t *index, uint8_t *end) {
+	uint8_t *probe_end = (end - index > SCAN_WHITESPACE_PROBE) ? index + SCAN_WHITESPACE_PROBE : end;
+
+	while (index < probe_end && (scan_class[*index] & SCAN_WHITESPACE)) {
+		index++;
+	}
+	if (index == probe_end && index < end) {
+		index = KernelInUse()->whitespace(index, end);
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  ScanString
+*
+* Description:
+* Find the first byte of string text that needs processing: a quote, a
+* backslash, a control character (0x00 to 0x1F) or a byte that is not ASCII
+* (0x80 to 0xFF).
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that stops the string text, or end
+*
+* Notes:
+* Control characters and bytes that are not ASCII are both below 0x20 when
+* compared as signed bytes, so one compare finds them.
+*
+******************************************************************************/
+uint8_t *ScanString(uint8_t *index, uint8_t *end) {
+	return KernelInUse()->string(index, end);
+}
+
+/******************************************************************************
+* Function Name:  ScanLines
+*
+* Description:
+* Count the line feeds of a text and find the start of its last line.
+*
+* Parameters:
+* index		const uint8_t *		pointer to the first byte to scan
+* end		const uint8_t *		pointer to one past the last byte to scan
+* line_start	const uint8_t **	set to one past the last line feed, left as
+*								it is if there is none
+*
+* Return Value:
+* size_t		number of line feeds
+*
+* Notes:
+* The vector kernels compare a block at a time and count the bits of the mask,
+* the last line feed is the highest bit of the last mask that is not 0.
+*
+******************************************************************************/
+size_t ScanLines(const uint8_t *index, const uint8_t *end, const uint8_t **line_start) {
+	return KernelInUse()->lines(index, end, line_start);
+}
+
+/******************************************************************************
+* Function Name:  ScanUTF8
+*
+* Description:
+* Check that string text is UTF-8, up to the first quote, backslash or
+* control character.  Overlong forms, surrogates (U+D800 to U+DFFF) and code
+* points past U+10FFFF are invalid.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+* state		uint8_t *		SCAN_UTF8_ACCEPT, or the state left by the last
+*							call if a character was cut by the end of text,
+*							set to the state at the returned byte
+*
+* Return Value:
+* uint8_t *		pointer to the quote, backslash or control character that
+*				stops the text, the first byte that is not valid UTF-8, or end
+*
+* Notes:
+* *state is SCAN_UTF8_INVALID if the returned byte is not valid UTF-8, which
+* includes a quote, backslash or control character inside a character.  At
+* end, *state is not SCAN_UTF8_ACCEPT if a character was cut by the end.
+* The vector kernels check a block at a time with every block starting on
+* the first byte of a character, a block with an error is scanned again a
+* byte at a time to find the byte.
+*
+******************************************************************************/
+uint8_t *ScanUTF8(uint8_t *index, uint8_t *end, uint8_t *state) {
+	bool stopped = false;		//a vector kernel found the stop
+
+	//finish the character cut by the end of the last chunk
+	if (*state != SCAN_UTF8_ACCEPT) {
+		index = ScanUTF8Bytes(index, end, state, true);
+	}
+	if (*state == SCAN_UTF8_ACCEPT && index < end && !(scan_class[*index] & SCAN_STRING_STOP)) {
+		index = KernelInUse()->utf8(index, end, &stopped);
+	}
+	//find the stop or the exact invalid byte
+	if (*state == SCAN_UTF8_ACCEPT && !stopped) {
+		index = ScanUTF8Bytes(index, end, state, false);
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  ScanStructure
+*
+* Description:
+* Find the bytes of a block of text that give it structure: quotes,
+* backslashes, commas, open and close brackets and braces.  Each kind is
+* returned as a mask with one bit per byte, the first byte in the low bit.
+*
+* Parameters:
+* block		const uint8_t *			pointer to SCAN_BLOCK_SIZE bytes of text
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:
+* Bytes inside strings are not told apart, the caller finds the strings from
+* the quote and backslash masks.
+*
+******************************************************************************/
+void ScanStructure(const uint8_t *block, scan_structure_t *masks) {
+	KernelInUse()->structure(block, masks);
+}
+
+/******************************************************************************
+* Function Name:  KernelInUse
+*
+* Description:
+* Give the kernel the scanning functions use, choosing it the first time.
+*
+* Parameters:	None.
+*
+* Return Value:
+* const scan_kernel_t *		kernel in use
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline const scan_kernel_t *KernelInUse(void) {
+	const scan_kernel_t *kernel = atomic_load_explicit(&scan_kernel, memory_order_relaxed);
+
+	return (kernel != NULL) ? kernel : ScanSelect();
+}
+
+/******************************************************************************
+* Function Name:  ScanSelect
+*
+* Description:
+* Choose the kernel for the first scan, from the environment or the fastest
+* the processor runs.
+*
+* Parameters:	None.
+*
+* Return Value:
+* const scan_kernel_t *		kernel chosen
+*
+* Notes:
+* Threads that make their first scan at the same time each choose the same
+* kernel.
+*
+******************************************************************************/
+static const scan_kernel_t *ScanSelect(void) {
+	ScanUseKernel(NULL);
+
+	return atomic_load_explicit(&scan_kernel, memory_order_relaxed);
+}
+
+/******************************************************************************
+* Function Name:  CPUKernels
+*
+* Description:
+* Find how many of the kernels, from the slowest, the processor can run.
+*
+* Parameters:	None.
+*
+* Return Value:
+* uint32_t		1 for scalar, 2 with SSE4.2, 3 with AVX2 and 4 with AVX-512
+*
+* Notes:
+* The AVX kernels also need the operating system to save the wider registers,
+* which xgetbv gives.
+*
+******************************************************************************/
+static uint32_t CPUKernels(void) {
+	uint32_t count = 1;
+#if defined(SCAN_DISPATCH)
+	uint32_t leaf_0[4] = { 0 };	//eax, ebx, ecx, edx
+	uint32_t leaf_1[4] = { 0 };
+	uint32_t leaf_7[4] = { 0 };
+	uint64_t xcr0 = 0;
+
+	CPUID(0, 0, leaf_0);
+	if (leaf_0[0] >= 1) {
+		CPUID(1, 0, leaf_1);
+	}
+	if (leaf_0[0] >= 7) {
+		CPUID(7, 0, leaf_7);
+	}
+	if (leaf_1[2] & CPUID_1_ECX_OSXSAVE) {
+		xcr0 = XGetBV();
+	}
+	if ((leaf_1[2] & CPUID_1_ECX_SSE42) && (leaf_1[2] & CPUID_1_ECX_POPCNT)) {
+		count = 2;
+	}
+	if (count == 2 && (leaf_1[2] & CPUID_1_ECX_AVX) && (xcr0 & XCR0_AVX) == XCR0_AVX &&
+		(leaf_7[1] & CPUID_7_EBX_AVX2) && (leaf_7[1] & CPUID_7_EBX_BMI1)) {
+		count = 3;
+	}
+	if (count == 3 && (xcr0 & XCR0_AVX512) == XCR0_AVX512 &&
+		(leaf_7[1] & CPUID_7_EBX_AVX512F) && (leaf_7[1] & CPUID_7_EBX_AVX512BW)) {
+		count = 4;
+	}
+#endif
+
+	return count;
+}
+
+/******************************************************************************
+* Function Name:  WhitespaceBytes
+*
+* Description:
+* Skip whitespace one byte at a time, the scalar kernel and the end of the
+* vector kernels.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that is not whitespace, or end
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint8_t *WhitespaceBytes(uint8_t *index, uint8_t *end) {
+	while (index < end && (scan_class[*index] & SCAN_WHITESPACE)) {
+		index++;
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  StringBytes
+*
+* Description:
+* Skip string text one byte at a time, the scalar kernel and the end of the
+* vector kernels.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that stops the string text, or end
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint8_t *StringBytes(uint8_t *index, uint8_t *end) {
+	while (index < end && !(scan_class[*index] & SCAN_STRING_STOP) && *index < CHAR_ASCII_END) {
+		index++;
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  LinesBytes
+*
+* Description:
+* Count line feeds one byte at a time, the scalar kernel and the end of the
+* vector kernels.
+*
+* Parameters:
+* index		const uint8_t *		pointer to the first byte to scan
+* end		const uint8_t *		pointer to one past the last byte to scan
+* line_start	const uint8_t **	set to one past the last line feed
+*
+* Return Value:
+* size_t		number of line feeds
+*
+* Notes:	None.
+*
+******************************************************************************/
+static size_t LinesBytes(const uint8_t *index, const uint8_t *end, const uint8_t **line_start) {
+	size_t lines = 0;
+
+	while (index < end) {
+		if (*index == '\n') {
+			lines++;
+			*line_start = index + 1;
+		}
+		index++;
+	}
+
+	return lines;
+}
+
+/******************************************************************************
+* Function Name:  UTF8Blocks
+*
+* Description:
+* The scalar kernel of ScanUTF8(), which leaves all of the text to be checked
+* a byte at a time.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte of a character
+* end		uint8_t *		pointer to one past the last byte of text
+* stopped	bool *			left false
+*
+* Return Value:
+* uint8_t *		index
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint8_t *UTF8Blocks(uint8_t *index, uint8_t *end, bool *stopped) {
+	(void)end;
+	(void)stopped;
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  StructureBytes
+*
+* Description:
+* Find the structure masks of a block one byte at a time.
+*
+* Parameters:
+* block		const uint8_t *			pointer to SCAN_BLOCK_SIZE bytes of text
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void StructureBytes(const uint8_t *block, scan_structure_t *masks) {
+	uint64_t bit;
+
+	memset(masks, 0, sizeof(scan_structure_t));
+	for (uint32_t index = 0; index < SCAN_BLOCK_SIZE; index++) {
+		bit = (uint64_t)1 << index;
+		switch (block[index]) {
+		case '"':
+			masks->quote |= bit;
+			break;
+		case '\\':
+			masks->backslash |= bit;
+			break;
+		case ',':
+			masks->comma |= bit;
+			break;
+		case '{':
+			masks->object_open |= bit;
+			break;
+		case '[':
+			masks->array_open |= bit;
+			break;
+		case '}':
+		case ']':
+			masks->close |= bit;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/******************************************************************************
+* Function Name:  ScanUTF8Bytes
+*
+* Description:
+* Check UTF-8 string text one byte at a time.
+*
+* Parameters:
+* index				uint8_t *		pointer to the first byte to scan
+* end				uint8_t *		pointer to one past the last byte of text
+* state				uint8_t *		state at index, set to the state at the
+*									returned byte
+* character_only	bool			stop at the end of the character in
+*									progress instead of a stop byte
+*
+* Return Value:
+* uint8_t *		pointer to the byte the scan stopped at, see ScanUTF8()
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint8_t *ScanUTF8Bytes(uint8_t *index, uint8_t *end, uint8_t *state, bool character_only) {
+	bool run_end = (character_only && *state == SCAN_UTF8_ACCEPT);
+
+	while (!run_end && index < end) {
+		if (*state == SCAN_UTF8_ACCEPT) {
+			if (*index < CHAR_ASCII_END) {
+				run_end = (scan_class[*index] & SCAN_STRING_STOP);
+			} else {
+				*state = UTF8Lead(*index);
+				run_end = (*state == SCAN_UTF8_INVALID);
+			}
+		} else if (*index < utf8_low[*state] || *index > utf8_high[*state]) {
+			*state = SCAN_UTF8_INVALID;
+			run_end = true;
+		} else {
+			*state = utf8_next[*state];
+			run_end = (character_only && *state == SCAN_UTF8_ACCEPT);
+			index++;
+			continue;
+		}
+		if (!run_end) {
+			index++;
+		}
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  UTF8Lead
+*
+* Description:
+* Find the state after the first byte of a character that is not ASCII.
+*
+* Parameters:
+* byte		uint8_t		byte of 0x80 to 0xFF
+*
+* Return Value:
+* uint8_t		state for the rest of the character, or SCAN_UTF8_INVALID if
+*				the byte can not start a character
+*
+* Notes:	None.
+*
+******************************************************************************/
+static uint8_t UTF8Lead(uint8_t byte) {
+	uint8_t state = SCAN_UTF8_INVALID;
+
+	if (byte >= 0xC2 && byte <= 0xDF) {
+		state = UTF8_TAIL_1;
+	} else if (byte == 0xE0) {
+		state = UTF8_E0;
+	} else if (byte == 0xED) {
+		state = UTF8_ED;
+	} else if (byte >= 0xE1 && byte <= 0xEF) {
+		state = UTF8_TAIL_2;
+	} else if (byte == 0xF0) {
+		state = UTF8_F0;
+	} else if (byte == 0xF4) {
+		state = UTF8_F4;
+	} else if (byte >= 0xF1 && byte <= 0xF3) {
+		state = UTF8_TAIL_3;
+	}
+
+	return state;
+}
+
+#if defined(SCAN_DISPATCH)
+/******************************************************************************
+* Function Name:  CPUID
+*
+* Description:
+* Read a leaf of cpuid.
+*
+* Parameters:
+* leaf			uint32_t		leaf to read, at most the highest leaf of leaf 0
+* subleaf		uint32_t		subleaf to read
+* registers		uint32_t *		eax, ebx, ecx and edx of the leaf
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+static void CPUID(uint32_t leaf, uint32_t subleaf, uint32_t *registers) {
+#if defined(_MSC_VER)
+	__cpuidex((int *)registers, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+/******************************************************************************
+* Function Name:  XGetBV
+*
+* Description:
+* Read XCR0, the registers the operating system saves on a context switch.
+*
+* Parameters:	None.
+*
+* Return Value:
+* uint64_t		value of XCR0
+*
+* Notes:
+* Only call when cpuid gives OSXSAVE.
+*
+******************************************************************************/
+static uint64_t XGetBV(void) {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t low;
+	uint32_t high;
+
+	__asm__ volatile ("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return ((uint64_t)high << 32) | low;
+#endif
+}
+
+/******************************************************************************
+* Function Name:  UTF8Cut
+*
+* Description:
+* Find how many bytes at the end of a valid block belong to a character cut
+* by the end of the block.
+*
+* Parameters:
+* block_end		uint8_t *		pointer to one past the last byte of the block
+*
+* Return Value:
+* uint32_t		0 to 3 bytes of the cut character
+*
+* Notes:
+* The block has been checked, so only the first byte of a cut character can
+* be 0xC0 or more.
+*
+******************************************************************************/
+static uint32_t UTF8Cut(uint8_t *block_end) {
+	uint32_t cut = 0;
+
+	if (block_end[-1] >= 0xC0) {
+		cut = 1;
+	} else if (block_end[-2] >= 0xE0) {
+		cut = 2;
+	} else if (block_end[-3] >= 0xF0) {
+		cut = 3;
+	}
+
+	return cut;
+}
+
+/******************************************************************************
+* Function Name:  WhitespaceSSE42
+*
+* Description:
+* Skip whitespace 16 bytes at a time with SSE4.2.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that is not whitespace, or end
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static uint8_t *WhitespaceSSE42(uint8_t *index, uint8_t *end) {
+	const __m128i set = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	bool run_end = false;
+	int position;
+
+	while (!run_end && end - index >= 16) {
+		position = _mm_cmpestri(set, 4, _mm_loadu_si128((const __m128i *)index), 16,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+		index += position;
+		run_end = (position < 16);
+	}
+
+	return run_end ? index : WhitespaceBytes(index, end);
+}
+
+/******************************************************************************
+* Function Name:  StringSSE42
+*
+* Description:
+* Skip string text 16 bytes at a time with SSE4.2.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that stops the string text, or end
+*
+* Notes:
+* One range compare finds control characters, quotes, backslashes and bytes
+* that are not ASCII.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static uint8_t *StringSSE42(uint8_t *index, uint8_t *end) {
+	const __m128i ranges = _mm_setr_epi8(0x00, CHAR_CONTROL_MAX, '"', '"', '\\', '\\',
+		(char)CHAR_ASCII_END, (char)0xFF, 0, 0, 0, 0, 0, 0, 0, 0);
+	bool run_end = false;
+	int position;
+
+	while (!run_end && end - index >= 16) {
+		position = _mm_cmpestri(ranges, 8, _mm_loadu_si128((const __m128i *)index), 16,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+		index += position;
+		run_end = (position < 16);
+	}
+
+	return run_end ? index : StringBytes(index, end);
+}
+
+/******************************************************************************
+* Function Name:  LinesSSE42
+*
+* Description:
+* Count line feeds 16 bytes at a time with SSE4.2.
+*
+* Parameters:
+* index		const uint8_t *		pointer to the first byte to scan
+* end		const uint8_t *		pointer to one past the last byte to scan
+* line_start	const uint8_t **	set to one past the last line feed
+*
+* Return Value:
+* size_t		number of line feeds
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static size_t LinesSSE42(const uint8_t *index, const uint8_t *end, const uint8_t **line_start) {
+	const __m128i linefeed = _mm_set1_epi8('\n');
+	size_t lines = 0;
+	uint32_t mask;
+
+	while (end - index >= 16) {
+		mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(
+			_mm_loadu_si128((const __m128i *)index), linefeed));
+		if (mask != 0) {
+			lines += CountBits(mask);
+			*line_start = index + 64 - CountLeadingZeros(mask);
+		}
+		index += 16;
+	}
+
+	return lines + LinesBytes(index, end, line_start);
+}
+
+/******************************************************************************
+* Function Name:  UTF8SSE42
+*
+* Description:
+* Check string text is UTF-8 16 bytes at a time with SSE4.2, up to the block
+* with the stop or an error.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte of a character
+* end		uint8_t *		pointer to one past the last byte of text
+* stopped	bool *			set true if the returned byte is the stop
+*
+* Return Value:
+* uint8_t *		pointer to the stop, or the first byte of the character the
+*				rest of the text is checked from
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static uint8_t *UTF8SSE42(uint8_t *index, uint8_t *end, bool *stopped) {
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i space = _mm_set1_epi8(' ');
+	bool run_end = false;
+	__m128i text;
+	__m128i error_bytes;
+	uint32_t stop;
+	uint32_t not_ascii;
+	uint32_t errors;
+	uint32_t cut;
+
+	while (!run_end && end - index >= 16) {
+		text = _mm_loadu_si128((const __m128i *)index);
+		not_ascii = (uint32_t)_mm_movemask_epi8(text);
+		stop = (uint32_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(text, quote), _mm_cmpeq_epi8(text, backslash)),
+			_mm_cmpgt_epi8(space, text))) & ~not_ascii;
+		errors = 0;
+		if (not_ascii != 0) {
+			error_bytes = UTF8Errors128(text);
+			errors = 0xFFFF & ~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(error_bytes, _mm_setzero_si128()));
+		}
+		if (stop != 0) {
+			errors &= (stop ^ (stop - 1));	//errors up to and at the stop
+		}
+		if (errors != 0) {
+			run_end = true;
+		} else if (stop != 0) {
+			index += CountTrailingZeros(stop);
+			*stopped = true;
+			run_end = true;
+		} else {
+			cut = UTF8Cut(index + 16);
+			index += 16 - cut;
+		}
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  UTF8Errors128
+*
+* Description:
+* Find the bytes of a 16 byte block that are not valid UTF-8, the same as
+* UTF8Errors256().
+*
+* Parameters:
+* text		__m128i		block that starts on the first byte of a character
+*
+* Return Value:
+* __m128i		non-zero bytes at errors
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static inline __m128i UTF8Errors128(__m128i text) {
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i before = _mm_setzero_si128();
+	__m128i previous_1 = _mm_alignr_epi8(text, before, 15);
+	__m128i previous_2 = _mm_alignr_epi8(text, before, 14);
+	__m128i previous_3 = _mm_alignr_epi8(text, before, 13);
+	__m128i special;
+	__m128i continuations;
+
+	special = _mm_and_si128(_mm_and_si128(
+		_mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_HIGH), _mm_and_si128(_mm_srli_epi16(previous_1, 4), nibble)),
+		_mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_1_LOW), _mm_and_si128(previous_1, nibble))),
+		_mm_shuffle_epi8(_mm_setr_epi8(UTF8_BYTE_2_HIGH), _mm_and_si128(_mm_srli_epi16(text, 4), nibble)));
+	continuations = _mm_and_si128(_mm_or_si128(
+		_mm_subs_epu8(previous_2, _mm_set1_epi8((char)(0xE0 - 0x80))),
+		_mm_subs_epu8(previous_3, _mm_set1_epi8((char)(0xF0 - 0x80)))),
+		_mm_set1_epi8((char)0x80));
+
+	return _mm_xor_si128(special, continuations);
+}
+/******************************************************************************
+* Function Name:  StructureSSE42
+*
+* Description:
+* Find the structure masks of a block 16 bytes at a time with SSE4.2.
+*
+* Parameters:
+* block		const uint8_t *			pointer to SCAN_BLOCK_SIZE bytes of text
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_SSE42 static void StructureSSE42(const uint8_t *block, scan_structure_t *masks) {
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i object_open = _mm_set1_epi8('{');
+	const __m128i array_open = _mm_set1_epi8('[');
+	const __m128i object_close = _mm_set1_epi8('}');
+	const __m128i array_close = _mm_set1_epi8(']');
+	__m128i text;
+	uint32_t shift;
+
+	memset(masks, 0, sizeof(scan_structure_t));
+	for (uint32_t part = 0; part < SCAN_BLOCK_SIZE / 16; part++) {
+		text = _mm_loadu_si128((const __m128i *)(block + part * 16));
+		shift = part * 16;
+		masks->quote |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(text, quote)) << shift;
+		masks->backslash |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(text, backslash)) << shift;
+		masks->comma |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(text, comma)) << shift;
+		masks->object_open |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(text, object_open)) << shift;
+		masks->array_open |= (uint64_t)_mm_movemask_epi8(_mm_cmpeq_epi8(text, array_open)) << shift;
+		masks->close |= (uint64_t)_mm_movemask_epi8(_mm_or_si128(
+			_mm_cmpeq_epi8(text, object_close), _mm_cmpeq_epi8(text, array_close))) << shift;
+	}
+}
+
+/******************************************************************************
+* Function Name:  WhitespaceAVX2
+*
+* Description:
+* Skip whitespace 32 bytes at a time with AVX2.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that is not whitespace, or end
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static uint8_t *WhitespaceAVX2(uint8_t *index, uint8_t *end) {
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i tab = _mm256_set1_epi8('\t');
+	const __m256i linefeed = _mm256_set1_epi8('\n');
+	const __m256i carriage_return = _mm256_set1_epi8('\r');
+	bool run_end = false;
+	__m256i text;
+	__m256i whitespace;
+	uint32_t mask;
+
+	while (!run_end && end - index >= 32) {
+		text = _mm256_loadu_si256((const __m256i *)index);
+		whitespace = _mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(text, space), _mm256_cmpeq_epi8(text, tab)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(text, linefeed), _mm256_cmpeq_epi8(text, carriage_return)));
+		mask = ~(uint32_t)_mm256_movemask_epi8(whitespace);
+		if (mask != 0) {
+			index += CountTrailingZeros(mask);
+			run_end = true;
+		} else {
+			index += 32;
+		}
+	}
+
+	return run_end ? index : WhitespaceBytes(index, end);
+}
+
+/******************************************************************************
+* Function Name:  StringAVX2
+*
+* Description:
+* Skip string text 32 or 64 bytes at a time with AVX2.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that stops the string text, or end
+*
+* Notes:
+* When the first 32 bytes are all string text the next 32 are checked in the
+* same pass, as long strings are often long.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static uint8_t *StringAVX2(uint8_t *index, uint8_t *end) {
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i space = _mm256_set1_epi8(' ');
+	bool run_end = false;
+	__m256i text_low;
+	__m256i text_high;
+	uint64_t mask;
+
+	while (!run_end && end - index >= 32) {
+		text_low = _mm256_loadu_si256((const __m256i *)index);
+		mask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(text_low, quote), _mm256_cmpeq_epi8(text_low, backslash)),
+			_mm256_cmpgt_epi8(space, text_low)));
+		if (mask == 0 && end - index >= 64) {
+			text_high = _mm256_loadu_si256((const __m256i *)(index + 32));
+			mask = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(text_high, quote), _mm256_cmpeq_epi8(text_high, backslash)),
+				_mm256_cmpgt_epi8(space, text_high))) << 32;
+			if (mask == 0) {
+				index += 32;
+			}
+		}
+		if (mask != 0) {
+			index += CountTrailingZeros(mask);
+			run_end = true;
+		} else {
+			index += 32;
+		}
+	}
+
+	return run_end ? index : StringBytes(index, end);
+}
+
+/******************************************************************************
+* Function Name:  LinesAVX2
+*
+* Description:
+* Count line feeds 32 bytes at a time with AVX2.
+*
+* Parameters:
+* index		const uint8_t *		pointer to the first byte to scan
+* end		const uint8_t *		pointer to one past the last byte to scan
+* line_start	const uint8_t **	set to one past the last line feed
+*
+* Return Value:
+* size_t		number of line feeds
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static size_t LinesAVX2(const uint8_t *index, const uint8_t *end, const uint8_t **line_start) {
+	const __m256i linefeed = _mm256_set1_epi8('\n');
+	size_t lines = 0;
+	uint32_t mask;
+
+	while (end - index >= 32) {
+		mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+			_mm256_loadu_si256((const __m256i *)index), linefeed));
+		if (mask != 0) {
+			lines += CountBits(mask);
+			*line_start = index + 64 - CountLeadingZeros(mask);
+		}
+		index += 32;
+	}
+
+	return lines + LinesBytes(index, end, line_start);
+}
+
+/******************************************************************************
+* Function Name:  UTF8AVX2
+*
+* Description:
+* Check string text is UTF-8 32 bytes at a time with AVX2, up to the block
+* with the stop or an error.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte of a character
+* end		uint8_t *		pointer to one past the last byte of text
+* stopped	bool *			set true if the returned byte is the stop
+*
+* Return Value:
+* uint8_t *		pointer to the stop, or the first byte of the character the
+*				rest of the text is checked from
+*
+* Notes:
+* The AVX-512 kernel uses this one too.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static uint8_t *UTF8AVX2(uint8_t *index, uint8_t *end, bool *stopped) {
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i space = _mm256_set1_epi8(' ');
+	bool run_end = false;
+	__m256i text;
+	uint32_t stop;
+	uint32_t not_ascii;
+	uint32_t errors;
+	uint32_t cut;
+
+	while (!run_end && end - index >= 32) {
+		text = _mm256_loadu_si256((const __m256i *)index);
+		not_ascii = (uint32_t)_mm256_movemask_epi8(text);
+		stop = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(
+			_mm256_or_si256(_mm256_cmpeq_epi8(text, quote), _mm256_cmpeq_epi8(text, backslash)),
+			_mm256_cmpgt_epi8(space, text))) & ~not_ascii;
+		errors = 0;
+		if (not_ascii != 0) {
+			errors = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(UTF8Errors256(text), _mm256_setzero_si256()));
+		}
+		if (stop != 0) {
+			errors &= (stop ^ (stop - 1));	//errors up to and at the stop
+		}
+		if (errors != 0) {
+			run_end = true;
+		} else if (stop != 0) {
+			index += CountTrailingZeros(stop);
+			*stopped = true;
+			run_end = true;
+		} else {
+			cut = UTF8Cut(index + 32);
+			index += 32 - cut;
+		}
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  UTF8Errors256
+*
+* Description:
+* Find the bytes of a 32 byte block that are not valid UTF-8, from the block
+* and the block shifted by 1, 2 and 3 bytes.
+*
+* Parameters:
+* text		__m256i		block that starts on the first byte of a character
+*
+* Return Value:
+* __m256i		non-zero bytes at errors
+*
+* Notes:
+* The lookups of the byte before and the byte give the errors of 2 byte
+* pairs.  The third and fourth bytes of 3 and 4 byte characters are found
+* from the byte 2 and 3 before.  The method is from "Validating UTF-8 In Less
+* Than One Instruction Per Byte", Keiser and Lemire, 2021.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static inline __m256i UTF8Errors256(__m256i text) {
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i before = _mm256_permute2x128_si256(_mm256_setzero_si256(), text, 0x21);
+	__m256i previous_1 = _mm256_alignr_epi8(text, before, 15);
+	__m256i previous_2 = _mm256_alignr_epi8(text, before, 14);
+	__m256i previous_3 = _mm256_alignr_epi8(text, before, 13);
+	__m256i special;
+	__m256i continuations;
+
+	special = _mm256_and_si256(_mm256_and_si256(
+		_mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_HIGH, UTF8_BYTE_1_HIGH),
+			_mm256_and_si256(_mm256_srli_epi16(previous_1, 4), nibble)),
+		_mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_1_LOW, UTF8_BYTE_1_LOW),
+			_mm256_and_si256(previous_1, nibble))),
+		_mm256_shuffle_epi8(_mm256_setr_epi8(UTF8_BYTE_2_HIGH, UTF8_BYTE_2_HIGH),
+			_mm256_and_si256(_mm256_srli_epi16(text, 4), nibble)));
+	continuations = _mm256_and_si256(_mm256_or_si256(
+		_mm256_subs_epu8(previous_2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+		_mm256_subs_epu8(previous_3, _mm256_set1_epi8((char)(0xF0 - 0x80)))),
+		_mm256_set1_epi8((char)0x80));
+
+	return _mm256_xor_si256(special, continuations);
+}
+/******************************************************************************
+* Function Name:  StructureAVX2
+*
+* Description:
+* Find the structure masks of a block 32 bytes at a time with AVX2.
+*
+* Parameters:
+* block		const uint8_t *			pointer to SCAN_BLOCK_SIZE bytes of text
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+SCAN_TARGET_AVX2 static void StructureAVX2(const uint8_t *block, scan_structure_t *masks) {
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i comma = _mm256_set1_epi8(',');
+	const __m256i object_open = _mm256_set1_epi8('{');
+	const __m256i array_open = _mm256_set1_epi8('[');
+	const __m256i object_close = _mm256_set1_epi8('}');
+	const __m256i array_close = _mm256_set1_epi8(']');
+	__m256i low = _mm256_loadu_si256((const __m256i *)block);
+	__m256i high = _mm256_loadu_si256((const __m256i *)(block + 32));
+
+#define SCAN_MASK(low, high)	((uint64_t)(uint32_t)_mm256_movemask_epi8(low) | \
+		((uint64_t)(uint32_t)_mm256_movemask_epi8(high) << 32))
+	masks->quote = SCAN_MASK(_mm256_cmpeq_epi8(low, quote), _mm256_cmpeq_epi8(high, quote));
+	masks->backslash = SCAN_MASK(_mm256_cmpeq_epi8(low, backslash), _mm256_cmpeq_epi8(high, backslash));
+	masks->comma = SCAN_MASK(_mm256_cmpeq_epi8(low, comma), _mm256_cmpeq_epi8(high, comma));
+	masks->object_open = SCAN_MASK(_mm256_cmpeq_epi8(low, object_open), _mm256_cmpeq_epi8(high, object_open));
+	masks->array_open = SCAN_MASK(_mm256_cmpeq_epi8(low, array_open), _mm256_cmpeq_epi8(high, array_open));
+	masks->close = SCAN_MASK(
+		_mm256_or_si256(_mm256_cmpeq_epi8(low, object_close), _mm256_cmpeq_epi8(low, array_close)),
+		_mm256_or_si256(_mm256_cmpeq_epi8(high, object_close), _mm256_cmpeq_epi8(high, array_close)));
+#undef SCAN_MASK
+}
+
+/******************************************************************************
+* Function Name:  WhitespaceAVX512
+*
+* Description:
+* Skip whitespace 64 bytes at a time with AVX-512.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that is not whitespace, or end
+*
+* Notes:
+* The last block is loaded with the bytes past the end masked off, masked
+* bytes are not read.
+*
+******************************************************************************/
+SCAN_TARGET_AVX512 static uint8_t *WhitespaceAVX512(uint8_t *index, uint8_t *end) {
+	const __m512i space = _mm512_set1_epi8(' ');
+	const __m512i tab = _mm512_set1_epi8('\t');
+	const __m512i linefeed = _mm512_set1_epi8('\n');
+	const __m512i carriage_return = _mm512_set1_epi8('\r');
+	bool run_end = false;
+	__m512i text;
+	uint64_t valid;
+	uint64_t mask;
+
+	while (!run_end && index < end) {
+		valid = SCAN_MASK_64((size_t)(end - index));
+		text = _mm512_maskz_loadu_epi8(valid, index);
+		mask = ~(_mm512_cmpeq_epi8_mask(text, space) | _mm512_cmpeq_epi8_mask(text, tab) |
+			_mm512_cmpeq_epi8_mask(text, linefeed) | _mm512_cmpeq_epi8_mask(text, carriage_return)) & valid;
+		if (mask != 0) {
+			index += CountTrailingZeros(mask);
+			run_end = true;
+		} else {
+			index += (valid == UINT64_MAX) ? 64 : (size_t)(end - index);
+		}
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  StringAVX512
+*
+* Description:
+* Skip string text 64 bytes at a time with AVX-512.
+*
+* Parameters:
+* index		uint8_t *		pointer to the first byte to scan
+* end		uint8_t *		pointer to one past the last byte of text
+*
+* Return Value:
+* uint8_t *		pointer to the first byte that stops the string text, or end
+*
+* Notes:
+* The last block is loaded with the bytes past the end masked off.
+*
+******************************************************************************/
+SCAN_TARGET_AVX512 static uint8_t *StringAVX512(uint8_t *index, uint8_t *end) {
+	const __m512i quote = _mm512_set1_epi8('"');
+	const __m512i backslash = _mm512_set1_epi8('\\');
+	const __m512i space = _mm512_set1_epi8(' ');
+	bool run_end = false;
+	__m512i text;
+	uint64_t valid;
+	uint64_t mask;
+
+	while (!run_end && index < end) {
+		valid = SCAN_MASK_64((size_t)(end - index));
+		text = _mm512_maskz_loadu_epi8(valid, index);
+		mask = (_mm512_cmpeq_epi8_mask(text, quote) | _mm512_cmpeq_epi8_mask(text, backslash) |
+			_mm512_cmplt_epi8_mask(text, space)) & valid;
+		if (mask != 0) {
+			index += CountTrailingZeros(mask);
+			run_end = true;
+		} else {
+			index += (valid == UINT64_MAX) ? 64 : (size_t)(end - index);
+		}
+	}
+
+	return index;
+}
+
+/******************************************************************************
+* Function Name:  LinesAVX512
+*
+* Description:
+* Count line feeds 64 bytes at a time with AVX-512.
+*
+* Parameters:
+* index		const uint8_t *		pointer to the first byte to scan
+* end		const uint8_t *		pointer to one past the last byte to scan
+* line_start	const uint8_t **	set to one past the last line feed
+*
+* Return Value:
+* size_t		number of line feeds
+*
+* Notes:
+* The last block is loaded with the bytes past the end masked off.
+*
+******************************************************************************/
+SCAN_TARGET_AVX512 static size_t LinesAVX512(const uint8_t *index, const uint8_t *end, const uint8_t **line_start) {
+	const __m512i linefeed = _mm512_set1_epi8('\n');
+	size_t lines = 0;
+	uint64_t valid;
+	uint64_t mask;
+
+	while (index < end) {
+		valid = SCAN_MASK_64((size_t)(end - index));
+		mask = _mm512_mask_cmpeq_epi8_mask(valid, _mm512_maskz_loadu_epi8(valid, index), linefeed);
+		if (mask != 0) {
+			lines += CountBits(mask);
+			*line_start = index + 64 - CountLeadingZeros(mask);
+		}
+		index += (valid == UINT64_MAX) ? 64 : (size_t)(end - index);
+	}
+
+	return lines;
+}
+
+/******************************************************************************
+* Function Name:  StructureAVX512
+*
+* Description:
+* Find the structure masks of a block in one load with AVX-512.
+*
+* Parameters:
+* block		const uint8_t *			pointer to SCAN_BLOCK_SIZE bytes of text
+* masks		scan_structure_t *		masks of the block
+*
+* Return Value:	None.
+*
+* Notes:
+* The compares give the masks directly, one bit per byte.
+*
+******************************************************************************/
+SCAN_TARGET_AVX512 static void StructureAVX512(const uint8_t *block, scan_structure_t *masks) {
+	__m512i text = _mm512_loadu_si512((const void *)block);
+
+	masks->quote = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8('"'));
+	masks->backslash = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8('\\'));
+	masks->comma = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8(','));
+	masks->object_open = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8('{'));
+	masks->array_open = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8('['));
+	masks->close = _mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8('}')) |
+		_mm512_cmpeq_epi8_mask(text, _mm512_set1_epi8(']'));
+}
+#endif
@@ -0,0 +1,212 @@
+/******************************************************************************
+* File Name:  JSONLintScan.h
+*
+* Description:
+* Scanning kernels used by the JSON lint to skip runs of whitespace and runs of
+* string text, to check that string text is UTF-8, to count the lines before
+* an error, and to find the strings and structure of a text when it is cut
+* into pieces to lint in parallel.  The kernels test 64 bytes at a time with
+* AVX-512, 32 or 64 bytes at a time with AVX2, 16 bytes at a time with SSE4.2,
+* or one byte at a time on other targets.  Runs of number digits are skipped
+* 8 bytes at a time in a 64-bit word on every target.
+*
+* LICENSE:
+* MIT License
+*
+* Copyright (c) 2019 EmbeddedWilderness
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Notes:
+* On x86 the kernel is chosen when the program runs, the fastest one cpuid
+* says the processor has, unless JSON_LINT_KERNEL in the environment names
+* another one: "scalar", "sse4.2", "avx2" or "avx512".  Other targets use
+* the scalar kernel.  No kernel reads at or past the end pointer.
+*
+******************************************************************************/
+#ifndef JSON_LINT_SCAN_H_
+#define JSON_LINT_SCAN_H_
+
+/******************************************************************************
+* Includes
+******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define SCAN_BLOCK_SIZE			64	//bytes of text in a block of masks
+
+#define SCAN_UTF8_ACCEPT		0x00	//ScanUTF8() state between characters
+#define SCAN_UTF8_INVALID		0xFF	//ScanUTF8() state after invalid UTF-8
+
+#define SCAN_WORD_ZERO			0x3030303030303030ULL	//'0' in each byte
+#define SCAN_WORD_LOW			0x7F7F7F7F7F7F7F7FULL	//low 7 bits of each byte
+#define SCAN_WORD_OVER_NINE		0x7676767676767676ULL	//carries into bit 7 of a
+														//byte over 9
+#define SCAN_WORD_HIGH			0x8080808080808080ULL	//bit 7 of each byte
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	uint64_t quote;				//quotes
+	uint64_t backslash;			//backslashes
+	uint64_t comma;				//commas
+	uint64_t object_open;		//open curly brackets
+	uint64_t array_open;		//open square brackets
+	uint64_t close;				//close curly or square brackets
+} scan_structure_t;
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+const char *ScanKernel(void);
+bool ScanUseKernel(const char *name);
+uint8_t *ScanWhitespace(uint8_t *index, uint8_t *end);
+uint8_t *ScanString(uint8_t *index, uint8_t *end);
+size_t ScanLines(const uint8_t *index, const uint8_t *end, const uint8_t **line_start);
+uint8_t *ScanUTF8(uint8_t *index, uint8_t *end, uint8_t *state);
+void ScanStructure(const uint8_t *block, scan_structure_t *masks);
+
+/******************************************************************************
+* Functions
+******************************************************************************/
+/******************************************************************************
+* Function Name:  CountTrailingZeros
+*
+* Description:
+* Find the position of the lowest set bit of the mask.
+*
+* Parameters:
+* mask		uint64_t		mask with at least one bit set
+*
+* Return Value:
+* uint32_t		position of the lowest set bit
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline uint32_t CountTrailingZeros(uint64_t mask) {
+#if defined(_MSC_VER)
+	unsigned long position;
+
+	_BitScanForward64(&position, mask);
+	return (uint32_t)position;
+#else
+	return (uint32_t)__builtin_ctzll(mask);
+#endif
+}
+
+/******************************************************************************
+* Function Name:  CountLeadingZeros
+*
+* Description:
+* Find the number of clear bits above the highest set bit of the mask.
+*
+* Parameters:
+* mask		uint64_t		mask with at least one bit set
+*
+* Return Value:
+* uint32_t		63 less the position of the highest set bit
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline uint32_t CountLeadingZeros(uint64_t mask) {
+#if defined(_MSC_VER)
+	unsigned long position;
+
+	_BitScanReverse64(&position, mask);
+	return 63 - (uint32_t)position;
+#else
+	return (uint32_t)__builtin_clzll(mask);
+#endif
+}
+
+/******************************************************************************
+* Function Name:  CountBits
+*
+* Description:
+* Count the set bits of the mask.
+*
+* Parameters:
+* mask		uint64_t		mask to count
+*
+* Return Value:
+* uint32_t		number of set bits
+*
+* Notes:	None.
+*
+******************************************************************************/
+static inline uint32_t CountBits(uint64_t mask) {
+#if defined(_MSC_VER)
+	return (uint32_t)__popcnt64(mask);
+#else
+	return (uint32_t)__builtin_popcountll(mask);
+#endif
+}
+
+/******************************************************************************
+* Function Name:  ScanDigits
+*
+* Description:
+* Skip a run of the digits 0 to 9.
+*
+* Parameters:
+* index		uint8_t *		start of the run
+* end		uint8_t *		end of the text
+*
+* Return Value:
+* uint8_t *		first byte that is not a digit, or end
+*
+* Notes:
+* Each byte of a word has '0' taken off with an exclusive or, leaving 0 to 9 for
+* a digit.  Adding 0x76 to the low 7 bits carries into bit 7 for 10 and over,
+* and any byte with bit 7 already set is not a digit either, so the lowest bit 7
+* set is the first byte that is not a digit.  The word is loaded little endian;
+* big endian targets use the byte loop.
+*
+******************************************************************************/
+static inline uint8_t *ScanDigits(uint8_t *index, uint8_t *end) {
+	uint64_t bytes;
+	uint64_t other = 0;
+
+#if !(defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	while (other == 0 && end - index >= 8) {
+		memcpy(&bytes, index, sizeof(bytes));
+		bytes ^= SCAN_WORD_ZERO;
+		other = (((bytes & SCAN_WORD_LOW) + SCAN_WORD_OVER_NINE) | bytes) & SCAN_WORD_HIGH;
+		index += (other == 0) ? 8 : CountTrailingZeros(other) / 8;
+	}
+#endif
+	while (index < end && (uint8_t)(*index - '0') < 10) {
+		index++;
+	}
+	return index;
+}
+
+#endif
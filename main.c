@@ -4,7 +4,10 @@
 * Description:
 * This is a test program of JSON lint.  It demonstrates the ability of the
 * JSON lint module and features that indicate result and where and error is
-* located.
+* located.  Build as:
+*		cc -O2 -pthread -o json_lint_test main.c JSONLint.c JSONLintScan.c
+*			JSONLintNDJSON.c JSONLintPool.c JSONLintParallel.c JSONLintCache.c
+*			JSONLintIncremental.c JSONLintBatch.c -DPARALLEL_CHUNK_MIN=64
 *
 * LICENSE:
 * MIT License
@@ -36,12 +39,82 @@
 /******************************************************************************
 * Includes
 ******************************************************************************/
+#include <errno.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include "JSONLint.h"
+#include "JSONLintScan.h"
+#include "JSONLintNDJSON.h"
+#include "JSONLintParallel.h"
+#include "JSONLintCache.h"
+#include "JSONLintIncremental.h"
+#include "JSONLintBatch.h"
+
+/******************************************************************************
+* Defines
+******************************************************************************/
+#define MAIN_ERRORS_SIZE		8	//most errors to report of the JSON string
+#define MAIN_ERROR_WINDOW		10	//bytes shown each side of an error
+#define MAIN_TEXT_SIZE			256	//bytes of the copy of a test case
+#define MAIN_NDJSON_THREADS		2	//threads of the NDJSON test
+#define MAIN_PARALLEL_THREADS		4	//threads of the parallel test
+#define MAIN_PARALLEL_REPEAT		24	//times each parallel piece is given
+#define MAIN_PARALLEL_SIZE		1024	//bytes of a parallel test text
+#define MAIN_TAPE_SIZE			16	//entries of the tape test
+#define MAIN_LIMIT_LENGTH		32	//limits of the limit test
+#define MAIN_LIMIT_STRING		4
+#define MAIN_LIMIT_NUMBER		4
+#define MAIN_LIMIT_MEMBERS		3
+#define MAIN_LIMIT_DEPTH		3
+#define MAIN_CACHE_SIZE			4	//results held by the cache test
+#define MAIN_DIALECT_MEMBERS		2	//most members of the dialect test
+#define MAIN_BATCH_SIZE			4	//documents of the batch test
+#define MAIN_BATCH_THREADS		2	//threads of the batch test
+
+/******************************************************************************
+* Type Definitions
+******************************************************************************/
+typedef struct {
+	const char *pointer;
+	size_t offset;				//offset of the value, or 0 if not found
+	size_t length;				//bytes of the value, or 0 if not found
+} tc_pointer_t;
+
+typedef struct {
+	const char *text;			//JSON text, NULL at the end of a table
+	json_lint_result_t result;	//result expected
+	json_lint_error_t error;	//error expected
+	size_t offset;				//offset of the invalid json expected
+} tc_case_t;
+
+typedef struct {
+	const char *text;
+	const char *minified;		//text without its whitespace, NULL if invalid
+} tc_minify_t;
+
+typedef struct {
+	const char *text;
+	json_lint_number_class_t number_class;
+} tc_number_t;
+
+typedef struct {
+	size_t offset;
+	json_lint_error_t error;
+	size_t line;
+	size_t column;
+} tc_recover_t;
+
+typedef struct {
+	size_t offset;				//offset of the edit
+	size_t removed;				//bytes of text replaced
+	const char *inserted;		//text that replaces them
+	tc_case_t expected;			//text after the edit, with its result
+	uint64_t full;				//lints of the whole text so far
+	uint64_t partial;			//lints of one object or array so far
+} tc_edit_t;
 
 /******************************************************************************
 * Variables
@@ -59,12 +132,203 @@ const uint8_t *tc_json[][2] = { {"false", RESULT_JSON_LINT_SUCCESS},
 {"[true, false,		null]", RESULT_JSON_LINT_SUCCESS},
 {"{ \"test 1\":3.4}true", RESULT_JSON_LINT_INVALID} ,
 {"{		\"test\":\"4k4k4\"}[false,false]", RESULT_JSON_LINT_INVALID},
+{"[\"a string longer than one block of the vector kernels, to test them\"]", RESULT_JSON_LINT_SUCCESS},
+{"[\"a string longer than one block of the vector kernels, \x01 in it\"]", RESULT_JSON_LINT_INVALID},
+{"[                                                                    1]", RESULT_JSON_LINT_SUCCESS},
+{"[\"caf\xC3\xA9 na\xC3\xAFve \xE2\x82\xAC \xF0\x9F\x98\x80 text long enough to fill a block of 64 bytes\"]", RESULT_JSON_LINT_SUCCESS},
+{"[\"overlong text long enough to fill a block of 64 bytes or more \xC0\xAF\"]", RESULT_JSON_LINT_INVALID},
+{"[\"surrogate text long enough to fill a block of 64 bytes or more \xED\xA0\x80\"]", RESULT_JSON_LINT_INVALID},
 {"",RESULT_JSON_LINT_SUCCESS} /*end of tests indicator*/ };
 
+const char *tc_kernels[] = { "scalar", "sse4.2", "avx2", "avx512", NULL };
+
+const char *tc_feed[] = { "[\"\\u0abc\",true]",
+"[\"\\u0abc\",null]",
+"{\"\\u00e9\":false}",
+"{\"key\":[1.5e-3,-0,\"a\\\"b\\n\",{\"k\":[null,true]}]}",
+"[\"caf\xC3\xA9 \xF0\x9F\x98\x80\",12345678901234567890]",
+"[1,2",
+"{\"a\" 1}",
+"[tru]",
+"[\"\\u00g0\"]",
+"[\"\xE2\x82\"]",
+NULL /*end of tests indicator*/ };
+
+const char *tc_ndjson = "{\"a\":1}\n\n[1,2\n  \"ok\"  \n{\"b\":tru}\r\n7\n";
+
+const json_lint_ndjson_error_t tc_ndjson_errors[] = {
+{3, 9, 13, ERROR_JSON_LINT_UNEXPECTED_END},
+{5, 23, 31, ERROR_JSON_LINT_INVALID_VALUE} };
+
+const char *tc_parallel[] = { "\"a\\\"b,[{\\\\\",",
+"{\"k\":[1,2.5e-3,null],\"\\\\\":true},",
+"[[[[[]]]]],",
+"\"\\u00e9\\ud83d\\ude00\",",
+"\"\xc3\xa9x\",",
+"[[[[[[",
+"{\"a\":tru},",
+"{\"a\":1]},",
+"\"\xc3(\",",
+"[1,]]],",
+NULL };
+
+const char *tc_tape_text = "{\"a\":[1,true],\"b\\\"\":null}";
+
+const json_lint_tape_t tc_tape[] = {
+{0, 8, TAPE_JSON_LINT_OBJECT_BEGIN, NUMBER_JSON_LINT_NONE},
+{1, 3, TAPE_JSON_LINT_KEY, NUMBER_JSON_LINT_NONE},
+{5, 5, TAPE_JSON_LINT_ARRAY_BEGIN, NUMBER_JSON_LINT_NONE},
+{6, 1, TAPE_JSON_LINT_NUMBER, NUMBER_JSON_LINT_NONE},
+{8, 4, TAPE_JSON_LINT_TRUE, NUMBER_JSON_LINT_NONE},
+{12, 2, TAPE_JSON_LINT_ARRAY_END, NUMBER_JSON_LINT_NONE},
+{14, 5, TAPE_JSON_LINT_KEY, NUMBER_JSON_LINT_NONE},
+{20, 4, TAPE_JSON_LINT_NULL, NUMBER_JSON_LINT_NONE},
+{24, 0, TAPE_JSON_LINT_OBJECT_END, NUMBER_JSON_LINT_NONE} };
+
+const char *tc_pointer_text = "{\"a\":[1,true],\"b\\\"\":null,\"c/d\":{\"e~\":\"x\"}}";
+
+const tc_pointer_t tc_pointer[] = {
+{"", 0, 42},
+{"/a", 5, 8},
+{"/a/1", 8, 4},
+{"/b\"", 20, 4},
+{"/c~1d/e~0", 37, 3},
+{"/a/2", 0, 0},
+{"/c", 0, 0},
+{"a", 0, 0},
+{"/a/01", 0, 0},
+{NULL, 0, 0} };
+
+const tc_case_t tc_duplicate_keys[] = {
+{"{\"\":1}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"\":1,\"\":2}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_DUPLICATE_KEY, 6},
+{"{\"a\":1,\"b\":{\"a\":2},\"a\":3}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_DUPLICATE_KEY, 19},
+{"{\"ab\":1,\"a\":2,\"b\":3,\"ab\":4}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_DUPLICATE_KEY, 20},
+{"{\"x\":[{\"k\":1},{\"k\":2}],\"y\":{\"x\":0}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0} /*end of tests indicator*/ };
+
+const tc_case_t tc_limits[] = {
+{"[\"abcd\",1234,[[]]]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":[1,2,3],\"b\":[1,2,3],\"c\":1}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":[1,2,3],\"b\":[1,2,3],\"c\":[1]}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_LARGE, 32},
+{"[\"abcde\"]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_STRING_TOO_LONG, 6},
+{"{\"abcde\":1}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_STRING_TOO_LONG, 6},
+{"[12345]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_NUMBER_TOO_LONG, 5},
+{"[1,2,3,4]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 6},
+{"{\"a\":1,\"b\":2,\"c\":3,\"d\":4}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 18},
+{"[[[[]]]]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_DEEP, 3},
+{NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0} };
+
+const tc_minify_t tc_minify[] = {
+{" { \"a\" : [ 1 , 2.5e3 ] ,\r\n\t\"b c\" : \" x  y \" } ", "{\"a\":[1,2.5e3],\"b c\":\" x  y \"}"},
+{"  \"a\\\" b\\\\\"  ", "\"a\\\" b\\\\\""},
+{"\n[ true , false , null ]\n", "[true,false,null]"},
+{"[[ ],{ }]", "[[],{}]"},
+{"  7  ", "7"},
+{"[1, 2", NULL},
+{NULL, NULL} };
+
+const tc_number_t tc_numbers[] = {
+{"1", NUMBER_JSON_LINT_INT64},
+{"-0", NUMBER_JSON_LINT_INT64},
+{"-9223372036854775808", NUMBER_JSON_LINT_INT64},
+{"9007199254740993", NUMBER_JSON_LINT_INT64},
+{"9223372036854775808", NUMBER_JSON_LINT_UINT64},
+{"18446744073709551615", NUMBER_JSON_LINT_UINT64},
+{"-9223372036854775809", NUMBER_JSON_LINT_DOUBLE},
+{"0.5", NUMBER_JSON_LINT_DOUBLE_EXACT},
+{"1.25e2", NUMBER_JSON_LINT_DOUBLE_EXACT},
+{"0.1", NUMBER_JSON_LINT_DOUBLE},
+{"1e400", NUMBER_JSON_LINT_OVERFLOW},
+{"1e-400", NUMBER_JSON_LINT_OVERFLOW},
+{NULL, NUMBER_JSON_LINT_NONE} };
+
+const char *tc_number_tape = "[1,0.1,1e400]";
+
+const tc_case_t tc_cache[] = {
+{"[1,2,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 5},
+{"{\"a\":[true,fals]}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 15},
+{"{\"a\":{\"b\":[1,2,3]}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0} /*end of tests indicator*/ };
+
+const tc_case_t tc_strict[] = {
+{"// c\n[1, /* two */ 2,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 0},
+{"{\"a\":1,}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_EXPECTED_KEY, 7},
+{"{\"a\":1 // c\n,\"b\":2,}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_EXPECTED_SEPARATOR, 7},
+{"/* x */ 7 /**/", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 0},
+{"[\"//\",\"/*\"]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"[1,,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 3},
+{"[1 / 2]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_EXPECTED_SEPARATOR, 3},
+{"[1] /* open", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TRAILING_TEXT, 4},
+{"[1,2,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 4},
+{"{\"a\":1,\"b\":2,}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 12},
+{"[1,2,3,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 4},
+{"{\"a\":1,\"b\":2,\"c\":3}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 12},
+{NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0} };
+
+const tc_case_t tc_relaxed[] = {
+{"// c\n[1, /* two */ 2,]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":1,}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":1 // c\n,\"b\":2,}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"/* x */ 7 /**/", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"[\"//\",\"/*\"]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"[1,,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 3},
+{"[1 / 2]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_COMMENT, 4},
+{"[1] /* open", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_UNEXPECTED_END, 11},
+{"[1,2,]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":1,\"b\":2,}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"[1,2,3,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 5},
+{"{\"a\":1,\"b\":2,\"c\":3}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_TOO_MANY_MEMBERS, 13},
+{NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0} };
+
+const char *tc_recover_text = "{\"a\":tru,\n \"b\":[1,,2],\n \"c\" 3,\n \"d\":\"ok\"}";
+
+const tc_recover_t tc_recover[] = {
+{8, ERROR_JSON_LINT_INVALID_VALUE, 1, 9},
+{18, ERROR_JSON_LINT_INVALID_VALUE, 2, 9},
+{28, ERROR_JSON_LINT_EXPECTED_COLON, 3, 6} };
+
+const char *tc_edit_text = "{\"a\":[1,2,3],\"b\":{\"c\":true}}";
+
+const tc_edit_t tc_edits[] = {
+{8, 1, "20", {"{\"a\":[1,20,3],\"b\":{\"c\":true}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 1, 1},
+{23, 4, "tru", {"{\"a\":[1,20,3],\"b\":{\"c\":tru}}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 26}, 2, 2},
+{23, 3, "false", {"{\"a\":[1,20,3],\"b\":{\"c\":false}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 3, 2},
+{20, 1, "d", {"{\"a\":[1,20,3],\"b\":{\"d\":false}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 3, 3},
+{6, 1, "[]", {"{\"a\":[[],20,3],\"b\":{\"d\":false}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 3, 4},
+{1, 3, "\"xy\"", {"{\"xy\":[[],20,3],\"b\":{\"d\":false}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 3, 5},
+{0, 0, " ", {" {\"xy\":[[],20,3],\"b\":{\"d\":false}}", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 4, 5},
+{0, 0, NULL, {NULL, RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0}, 0, 0} };
+
+const tc_case_t tc_batch[MAIN_BATCH_SIZE] = {
+{"[1,2]", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"{\"a\":\n tru}", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 10},
+{"\"x\"", RESULT_JSON_LINT_SUCCESS, ERROR_JSON_LINT_NONE, 0},
+{"[1,]", RESULT_JSON_LINT_INVALID, ERROR_JSON_LINT_INVALID_VALUE, 3} };
+
+const char *tc_batch_missing = "/nonexistent/json_lint_test.json";
+
 /******************************************************************************
 * Function Prototypes
 ******************************************************************************/
 void JSON_Test_Cases();
+void JSON_Test_Feed();
+void JSON_Test_NDJSON();
+void JSON_Test_Parallel();
+void JSON_Test_Tape();
+void JSON_Test_Pointer();
+void JSON_Test_Duplicate_Keys();
+void JSON_Test_Limits();
+void JSON_Test_Minify();
+void JSON_Test_Numbers();
+void JSON_Test_Cache();
+void JSON_Test_Dialect();
+void JSON_Test_Recover();
+void JSON_Test_Incremental();
+void JSON_Test_Batch();
+bool JSON_Check_Case(json_lint_context_t *ctx, const tc_case_t *tc, bool feed);
+json_lint_result_t JSON_Feed(json_lint_context_t *ctx, uint8_t *text, size_t length, size_t first, size_t chunk);
+void JSON_Print_Error(uint8_t *text, size_t length, json_lint_location_t *location, json_lint_error_t error);
 
 /******************************************************************************
 * Function Name:  main
@@ -72,55 +336,54 @@ void JSON_Test_Cases();
 * Description:
 * Test the JSON lint module by running some test cases that fail and succeed to
 * determine that the result will be correct.  The second part of the test shows
-* that a JSON string with an error can be indicated where the error is located
-* within the string.
+* that each error of a JSON string can be indicated where it is located within
+* the string.
 *
 * Parameters:	None.
 *
 * Return Value:	None.
 *
-* Notes:	None.
+* Notes:
+* The lint goes on after each error, up to MAIN_ERRORS_SIZE of them, and the
+* line and column of an error are only counted when it is printed.
 *
 ******************************************************************************/
 int main() {
-	json_lint_result_t result;
-	uint32_t error_start = 10;
-	uint32_t error_end = 10;
-	uint8_t error_text[22] = { 0 };
-	uint8_t error_indicator[22] = { 0 };
-	uint32_t i;
+	json_lint_context_t ctx;
+	json_lint_diagnostic_t errors[MAIN_ERRORS_SIZE];
+	json_lint_location_t location = { 0 };
+	size_t length = strlen((char *)my_string);
+	size_t i;
 
 	JSON_Test_Cases();
+	JSON_Test_Feed();
+	JSON_Test_NDJSON();
+	JSON_Test_Parallel();
+	JSON_Test_Tape();
+	JSON_Test_Pointer();
+	JSON_Test_Duplicate_Keys();
+	JSON_Test_Limits();
+	JSON_Test_Minify();
+	JSON_Test_Numbers();
+	JSON_Test_Cache();
+	JSON_Test_Dialect();
+	JSON_Test_Recover();
+	JSON_Test_Incremental();
+	JSON_Test_Batch();
 
-	printf("\r\nTest with an error...");
+	printf("\r\nTest with errors...");
 	printf("\r\nJSON string:\r\n%s\r\n\r\n", my_string);
-	result = LintJSON(&my_string[0],false);
-	switch (result) {
-	case RESULT_JSON_LINT_SUCCESS:
+	LintJSONInit(&ctx);
+	ctx.errors = errors;
+	ctx.errors_size = MAIN_ERRORS_SIZE;
+	if (LintJSONContext(&ctx, my_string, length) == RESULT_JSON_LINT_SUCCESS) {
 		printf("Sucessfully parsed JSON text.\r\n");
-		break;
-	case RESULT_JSON_LINT_INVALID:
-		if (abs(ptr_invalid_json - &my_string) < 10) {
-			error_start = abs(ptr_invalid_json - &my_string);
-		}
-		if (((&my_string + strlen(my_string)) - ptr_invalid_json) < 10) {
-			error_end = ((my_string + strlen(my_string)) - ptr_invalid_json);
-		}
-		if (error_start + error_end > 0) {
-			memcpy(&error_text, ptr_invalid_json -error_start, error_start + error_end);
-			error_text[error_start + error_end] = 0x00;
-		}
-		for (i = 0; i < error_start ; i++) {
-			error_indicator[i] = '_';
-		}
-		error_indicator[i] = '^';
-		error_indicator[i + 1] = 0x00;
-		printf("Error, issue found at: %s\r\n", error_text);
-		printf("                       %s\r\n", error_indicator);
-		break;
-	default:
-		break;
 	}
+	for (i = 0; i < ctx.error_count; i++) {
+		LintJSONLocate(my_string, errors[i].offset_invalid_json, &location);
+		JSON_Print_Error(my_string, length, &location, errors[i].error);
+	}
+	return 0;
 }
 
 /******************************************************************************
@@ -134,18 +397,175 @@ int main() {
 *
 * Return Value:	None.
 *
-* Notes:	None.
+* Notes:
+* The cases are run with each scanning kernel the processor has, then the
+* kernel is chosen again as it would be without the test.
 *
 ******************************************************************************/
 void JSON_Test_Cases() {
 	json_lint_result_t lint_result;
+	uint8_t index;
+	uint8_t kernel;
+	bool test_result;
+
+	for (kernel = 0; tc_kernels[kernel] != NULL; kernel++) {
+		if (ScanUseKernel(tc_kernels[kernel])) {
+			printf("Test cases (%s):  ", tc_kernels[kernel]);
+			index = 0;
+			test_result = true;
+			while (strlen(tc_json[index][0]) > 0) {
+				lint_result = LintJSON(tc_json[index][0], false);
+				if (lint_result != tc_json[index][1]) {
+					printf("FAIL test %i\r\n", index);
+					test_result = false;
+				}
+				index++;
+			}
+			if (test_result) {
+				printf("PASS\r\n");
+			}
+		}
+	}
+	ScanUseKernel(NULL);
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Feed
+*
+* Description:
+* This test case checks that text fed in chunks has the same result, error
+* and location as the whole text, wherever the chunks are cut: inside
+* strings, escapes, numbers and literal names.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* Each text is cut in two at every byte, then fed 1 and 3 bytes at a time.
+*
+******************************************************************************/
+void JSON_Test_Feed() {
+	json_lint_context_t whole;
+	json_lint_context_t fed;
+	json_lint_result_t whole_result;
+	json_lint_result_t fed_result;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length;
+	size_t split;
 	uint8_t index = 0;
 	bool test_result = true;
 
-	printf("Test cases:  ");
-	while (strlen(tc_json[index][0]) > 0) {
-		lint_result = LintJSON(tc_json[index][0], false);
-		if (lint_result != tc_json[index][1]) {
+	printf("Feed cases:  ");
+	while (tc_feed[index] != NULL) {
+		length = strlen(tc_feed[index]);
+		memcpy(text, tc_feed[index], length);
+		LintJSONInit(&whole);
+		whole_result = LintJSONContext(&whole, text, length);
+		for (split = 0; split <= length + 2; split++) {
+			LintJSONInit(&fed);
+			if (split <= length) {
+				fed_result = JSON_Feed(&fed, text, length, split, length);
+			} else {
+				fed_result = JSON_Feed(&fed, text, length, 1, (split == length + 1) ? 1 : 3);
+			}
+			if (fed_result != whole_result || fed.error != whole.error ||
+				(fed_result != RESULT_JSON_LINT_SUCCESS && fed.offset_invalid_json != whole.offset_invalid_json)) {
+				printf("FAIL test %i split %zu\r\n", index, split);
+				test_result = false;
+			}
+		}
+		index++;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_NDJSON
+*
+* Description:
+* This test case checks that NDJSON text gives the line, offset, location and
+* reason of each invalid record, and counts lines and records, skipping
+* blank lines and a line feed that ends the text.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_NDJSON() {
+	json_lint_ndjson_t ndjson;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length = strlen(tc_ndjson);
+	size_t count = sizeof(tc_ndjson_errors) / sizeof(tc_ndjson_errors[0]);
+	bool test_result;
+
+	printf("NDJSON cases:  ");
+	memcpy(text, tc_ndjson, length);
+	LintNDJSONInit(&ndjson);
+	ndjson.threads = MAIN_NDJSON_THREADS;
+	test_result = (LintNDJSON(&ndjson, text, length) == RESULT_JSON_LINT_INVALID &&
+		ndjson.lines == 6 && ndjson.records == 5 && ndjson.invalid == count);
+	for (size_t index = 0; test_result && index < count; index++) {
+		test_result = (ndjson.errors[index].line == tc_ndjson_errors[index].line &&
+			ndjson.errors[index].offset == tc_ndjson_errors[index].offset &&
+			ndjson.errors[index].offset_invalid_json == tc_ndjson_errors[index].offset_invalid_json &&
+			ndjson.errors[index].error == tc_ndjson_errors[index].error);
+	}
+	LintNDJSONFree(&ndjson);
+	printf(test_result ? "PASS\r\n" : "FAIL\r\n");
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Parallel
+*
+* Description:
+* This test case checks that a text linted on several threads gives the same
+* result, error and offset as one linted on the calling thread.  Each text is
+* an array of one piece given many times, so that strings, escapes, nesting
+* and errors fall across the chunks.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* The texts are only split into chunks when PARALLEL_CHUNK_MIN is made small
+* enough at build time, as the build line of this file does.
+*
+******************************************************************************/
+void JSON_Test_Parallel() {
+	json_lint_context_t whole;
+	json_lint_context_t split;
+	json_lint_result_t whole_result;
+	json_lint_result_t split_result;
+	uint8_t text[MAIN_PARALLEL_SIZE];
+	size_t piece;
+	size_t length;
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Parallel cases:  ");
+	while (tc_parallel[index] != NULL) {
+		piece = strlen(tc_parallel[index]);
+		text[0] = '[';
+		length = 1;
+		for (uint8_t repeat = 0; repeat < MAIN_PARALLEL_REPEAT; repeat++) {
+			memcpy(text + length, tc_parallel[index], piece);
+			length += piece;
+		}
+		text[length++] = '0';
+		text[length++] = ']';
+		LintJSONInit(&whole);
+		whole_result = LintJSONContext(&whole, text, length);
+		LintJSONInit(&split);
+		split_result = LintJSONParallel(&split, text, length, MAIN_PARALLEL_THREADS);
+		if (split_result != whole_result || split.error != whole.error ||
+			(split_result != RESULT_JSON_LINT_SUCCESS && split.offset_invalid_json != whole.offset_invalid_json)) {
 			printf("FAIL test %i\r\n", index);
 			test_result = false;
 		}
@@ -154,7 +574,680 @@ void JSON_Test_Cases() {
 	if (test_result) {
 		printf("PASS\r\n");
 	}
+}
 
+/******************************************************************************
+* Function Name:  JSON_Test_Tape
+*
+* Description:
+* This test case checks the type, offset and link of each tape entry, whole
+* and fed one byte at a time, and that a tape too small for the values makes
+* the text invalid.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Tape() {
+	json_lint_context_t ctx;
+	json_lint_tape_t tape[MAIN_TAPE_SIZE];
+	json_lint_result_t result;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length = strlen(tc_tape_text);
+	size_t count = sizeof(tc_tape) / sizeof(tc_tape[0]);
+	bool test_result = true;
+
+	printf("Tape cases:  ");
+	memcpy(text, tc_tape_text, length);
+	for (uint8_t pass = 0; test_result && pass < 2; pass++) {
+		memset(tape, 0, sizeof(tape));
+		LintJSONInit(&ctx);
+		ctx.tape = tape;
+		ctx.tape_size = MAIN_TAPE_SIZE;
+		if (pass == 0) {
+			result = LintJSONContext(&ctx, text, length);
+		} else {
+			result = JSON_Feed(&ctx, text, length, 1, 1);
+		}
+		test_result = (result == RESULT_JSON_LINT_SUCCESS && ctx.tape_count == count);
+		for (size_t index = 0; test_result && index < count; index++) {
+			test_result = (tape[index].offset == tc_tape[index].offset &&
+				tape[index].link == tc_tape[index].link &&
+				tape[index].type == tc_tape[index].type);
+		}
+	}
+	if (test_result) {
+		LintJSONInit(&ctx);
+		ctx.tape = tape;
+		ctx.tape_size = count - 1;
+		test_result = (LintJSONContext(&ctx, text, length) == RESULT_JSON_LINT_INVALID &&
+			ctx.error == ERROR_JSON_LINT_TAPE_FULL);
+	}
+	printf(test_result ? "PASS\r\n" : "FAIL\r\n");
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Pointer
+*
+* Description:
+* This test case checks the offset and length of the value named by each JSON
+* pointer, with escaped keys and array indexes, that pointers to no value find
+* nothing, and that no value is given when the text is invalid.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Pointer() {
+	json_lint_context_t ctx;
+	uint8_t text[MAIN_TEXT_SIZE];
+	uint8_t *value;
+	size_t value_length;
+	size_t length = strlen(tc_pointer_text);
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Pointer cases:  ");
+	memcpy(text, tc_pointer_text, length);
+	while (tc_pointer[index].pointer != NULL) {
+		LintJSONInit(&ctx);
+		if (LintJSONPointer(&ctx, text, length, tc_pointer[index].pointer, &value, &value_length) != RESULT_JSON_LINT_SUCCESS ||
+			value_length != tc_pointer[index].length ||
+			(value_length == 0 && value != NULL) ||
+			(value_length != 0 && value != text + tc_pointer[index].offset)) {
+			printf("FAIL test %i\r\n", index);
+			test_result = false;
+		}
+		index++;
+	}
+	text[length - 2] = ',';
+	LintJSONInit(&ctx);
+	if (LintJSONPointer(&ctx, text, length, "/a", &value, &value_length) != RESULT_JSON_LINT_INVALID ||
+		value != NULL || value_length != 0) {
+		printf("FAIL test %i\r\n", index);
+		test_result = false;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Duplicate_Keys
+*
+* Description:
+* This test case checks that a key given twice in an object is found, with
+* the empty key, and that the same key in other objects is not.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* Each case is linted whole and fed a byte at a time with one arena, so the
+* arena is reused from case to case as a caller would.
+*
+******************************************************************************/
+void JSON_Test_Duplicate_Keys() {
+	json_lint_context_t ctx;
+	json_lint_arena_t arena;
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Duplicate key cases:  ");
+	memset(&arena, 0, sizeof(arena));
+	LintJSONInit(&ctx);
+	ctx.key_arena = &arena;
+	while (tc_duplicate_keys[index].text != NULL) {
+		if (!JSON_Check_Case(&ctx, &tc_duplicate_keys[index], false) ||
+			!JSON_Check_Case(&ctx, &tc_duplicate_keys[index], true)) {
+			printf("FAIL test %i\r\n", index);
+			test_result = false;
+		}
+		index++;
+	}
+	LintJSONArenaFree(&arena);
+	if (test_result) {
+		printf("PASS\r\n");
+	}
 }
 
+/******************************************************************************
+* Function Name:  JSON_Test_Limits
+*
+* Description:
+* This test case checks that a text at each limit is valid, and that a text
+* past the limit on length, string, number, members or depth gives its error
+* and offset, whole and fed.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Limits() {
+	json_lint_context_t ctx;
+	uint8_t index = 0;
+	bool test_result = true;
 
+	printf("Limit cases:  ");
+	LintJSONInit(&ctx);
+	ctx.max_length = MAIN_LIMIT_LENGTH;
+	ctx.max_string = MAIN_LIMIT_STRING;
+	ctx.max_number = MAIN_LIMIT_NUMBER;
+	ctx.max_members = MAIN_LIMIT_MEMBERS;
+	ctx.max_depth = MAIN_LIMIT_DEPTH;
+	while (tc_limits[index].text != NULL) {
+		if (!JSON_Check_Case(&ctx, &tc_limits[index], false) ||
+			!JSON_Check_Case(&ctx, &tc_limits[index], true)) {
+			printf("FAIL test %i\r\n", index);
+			test_result = false;
+		}
+		index++;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Minify
+*
+* Description:
+* This test case checks the text written without its whitespace, to another
+* buffer, in place and fed one byte at a time, and that whitespace in strings
+* is kept.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Minify() {
+	json_lint_context_t ctx;
+	json_lint_result_t result;
+	json_lint_result_t expected;
+	uint8_t text[MAIN_TEXT_SIZE];
+	uint8_t output[MAIN_TEXT_SIZE];
+	size_t output_length;
+	size_t length;
+	size_t minified_length;
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Minify cases:  ");
+	while (tc_minify[index].text != NULL) {
+		length = strlen(tc_minify[index].text);
+		minified_length = (tc_minify[index].minified != NULL) ? strlen(tc_minify[index].minified) : 0;
+		expected = (tc_minify[index].minified != NULL) ? RESULT_JSON_LINT_SUCCESS : RESULT_JSON_LINT_INVALID;
+		for (uint8_t pass = 0; pass < 3; pass++) {
+			memcpy(text, tc_minify[index].text, length);
+			LintJSONInit(&ctx);
+			if (pass == 0) {
+				result = LintJSONMinify(&ctx, text, length, output, &output_length);
+			} else if (pass == 1) {
+				result = LintJSONMinify(&ctx, text, length, text, &output_length);
+				memcpy(output, text, output_length);
+			} else {
+				ctx.minify = output;
+				ctx.minify_size = sizeof(output);
+				result = JSON_Feed(&ctx, text, length, 1, 1);
+				output_length = (result == RESULT_JSON_LINT_SUCCESS) ? ctx.minify_length : 0;
+			}
+			if (result != expected || output_length != minified_length ||
+				(minified_length != 0 && memcmp(output, tc_minify[index].minified, minified_length) != 0)) {
+				printf("FAIL test %i pass %i\r\n", index, pass);
+				test_result = false;
+			}
+		}
+		index++;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Numbers
+*
+* Description:
+* This test case checks the class found for each number, whole and fed one
+* byte at a time, and that the tape gives the class of each number of an
+* array.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Numbers() {
+	json_lint_context_t ctx;
+	json_lint_result_t result;
+	json_lint_tape_t tape[MAIN_TAPE_SIZE];
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length;
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Number class cases:  ");
+	while (tc_numbers[index].text != NULL) {
+		length = strlen(tc_numbers[index].text);
+		memcpy(text, tc_numbers[index].text, length);
+		for (uint8_t pass = 0; pass < 2; pass++) {
+			LintJSONInit(&ctx);
+			ctx.classify_numbers = true;
+			if (pass == 0) {
+				result = LintJSONContext(&ctx, text, length);
+			} else {
+				result = JSON_Feed(&ctx, text, length, 1, 1);
+			}
+			if (result != RESULT_JSON_LINT_SUCCESS || ctx.number.number_class != tc_numbers[index].number_class) {
+				printf("FAIL test %i pass %i\r\n", index, pass);
+				test_result = false;
+			}
+		}
+		index++;
+	}
+	length = strlen(tc_number_tape);
+	memcpy(text, tc_number_tape, length);
+	LintJSONInit(&ctx);
+	ctx.classify_numbers = true;
+	ctx.tape = tape;
+	ctx.tape_size = MAIN_TAPE_SIZE;
+	if (LintJSONContext(&ctx, text, length) != RESULT_JSON_LINT_SUCCESS || ctx.tape_count != 5 ||
+		tape[1].number_class != NUMBER_JSON_LINT_INT64 || tape[2].number_class != NUMBER_JSON_LINT_DOUBLE ||
+		tape[3].number_class != NUMBER_JSON_LINT_OVERFLOW) {
+		printf("FAIL test %i\r\n", index);
+		test_result = false;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Cache
+*
+* Description:
+* This test case checks that a text linted twice through the cache is found
+* the second time, with the result, error and offset of the first lint.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* max_depth is set past JSON_LINT_DEPTH_MAX, which the first lint clamps in
+* the context, so the second lint only hits if the key is of the clamped
+* depth.
+*
+******************************************************************************/
+void JSON_Test_Cache() {
+	json_lint_cache_t *cache = LintJSONCacheCreate(MAIN_CACHE_SIZE);
+	json_lint_cache_stats_t stats;
+	json_lint_context_t ctx;
+	json_lint_result_t result;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length;
+	uint8_t index = 0;
+	uint8_t pass;
+	bool test_result = (cache != NULL);
+
+	printf("Cache cases:  ");
+	LintJSONInit(&ctx);
+	while (test_result && tc_cache[index].text != NULL) {
+		length = strlen(tc_cache[index].text);
+		memcpy(text, tc_cache[index].text, length);
+		ctx.max_depth = JSON_LINT_DEPTH_MAX + 1;
+		for (pass = 0; pass < 2; pass++) {
+			result = LintJSONCached(cache, &ctx, text, length);
+			LintJSONCacheStats(cache, &stats);
+			if (result != tc_cache[index].result || ctx.error != tc_cache[index].error ||
+				(result != RESULT_JSON_LINT_SUCCESS && ctx.offset_invalid_json != tc_cache[index].offset) ||
+				stats.hits != (uint64_t)(index + pass)) {
+				printf("FAIL test %i\r\n", index);
+				test_result = false;
+			}
+		}
+		index++;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+	LintJSONCacheFree(cache);
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Dialect
+*
+* Description:
+* This test case checks that comments and trailing commas are only valid in
+* the relaxed dialect, whole and fed, and that a slash that starts no comment
+* or a comment that is not closed is still invalid there.  A trailing comma
+* does not count as a member against ctx->max_members.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* Both tables hold the same texts, with the result of each dialect.
+*
+******************************************************************************/
+void JSON_Test_Dialect() {
+	json_lint_context_t strict;
+	json_lint_context_t relaxed;
+	uint8_t index = 0;
+	bool test_result = true;
+
+	printf("Dialect cases:  ");
+	LintJSONInit(&strict);
+	LintJSONInit(&relaxed);
+	strict.max_members = MAIN_DIALECT_MEMBERS;
+	relaxed.max_members = MAIN_DIALECT_MEMBERS;
+	relaxed.dialect = DIALECT_JSON_LINT_RELAXED;
+	while (tc_strict[index].text != NULL) {
+		if (!JSON_Check_Case(&strict, &tc_strict[index], false) ||
+			!JSON_Check_Case(&strict, &tc_strict[index], true) ||
+			!JSON_Check_Case(&relaxed, &tc_relaxed[index], false) ||
+			!JSON_Check_Case(&relaxed, &tc_relaxed[index], true)) {
+			printf("FAIL test %i\r\n", index);
+			test_result = false;
+		}
+		index++;
+	}
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Recover
+*
+* Description:
+* This test case checks that the lint goes on after each error, giving the
+* offset, reason, line and column of every error in order, and that no more
+* than ctx->errors_size errors are recorded.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Recover() {
+	json_lint_context_t ctx;
+	json_lint_diagnostic_t errors[MAIN_ERRORS_SIZE];
+	json_lint_location_t location;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length = strlen(tc_recover_text);
+	size_t count = sizeof(tc_recover) / sizeof(tc_recover[0]);
+	bool test_result;
+
+	printf("Recover cases:  ");
+	memcpy(text, tc_recover_text, length);
+	LintJSONInit(&ctx);
+	ctx.errors = errors;
+	ctx.errors_size = MAIN_ERRORS_SIZE;
+	test_result = (LintJSONContext(&ctx, text, length) == RESULT_JSON_LINT_INVALID &&
+		ctx.error_count == count && ctx.error == tc_recover[0].error &&
+		ctx.offset_invalid_json == tc_recover[0].offset);
+	for (size_t index = 0; test_result && index < count; index++) {
+		memset(&location, 0, sizeof(location));
+		LintJSONLocate(text, errors[index].offset_invalid_json, &location);
+		test_result = (errors[index].offset_invalid_json == tc_recover[index].offset &&
+			errors[index].error == tc_recover[index].error &&
+			location.line == tc_recover[index].line && location.column == tc_recover[index].column);
+	}
+	if (test_result) {
+		LintJSONInit(&ctx);
+		ctx.errors = errors;
+		ctx.errors_size = 1;
+		test_result = (LintJSONContext(&ctx, text, length) == RESULT_JSON_LINT_INVALID &&
+			ctx.error_count == 1 && errors[0].offset_invalid_json == tc_recover[0].offset);
+	}
+	printf(test_result ? "PASS\r\n" : "FAIL\r\n");
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Incremental
+*
+* Description:
+* This test case makes each edit in turn to one text and checks the result,
+* error and offset of the lint after it, and that an edit inside an object or
+* array of a valid text only lints that object or array.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:
+* After an invalid text, or an edit outside of every object and array, the
+* whole text is linted.
+*
+******************************************************************************/
+void JSON_Test_Incremental() {
+	json_lint_incremental_t *incremental = LintJSONIncrementalCreate();
+	json_lint_incremental_stats_t stats;
+	json_lint_context_t ctx;
+	json_lint_edit_t edit;
+	json_lint_result_t result;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length = strlen(tc_edit_text);
+	uint8_t index = 0;
+	bool test_result = (incremental != NULL);
+
+	printf("Incremental cases:  ");
+	memcpy(text, tc_edit_text, length);
+	LintJSONInit(&ctx);
+	if (test_result && LintJSONIncremental(incremental, &ctx, text, length, NULL) != RESULT_JSON_LINT_SUCCESS) {
+		printf("FAIL first lint\r\n");
+		test_result = false;
+	}
+	while (test_result && tc_edits[index].inserted != NULL) {
+		edit.offset = tc_edits[index].offset;
+		edit.removed = tc_edits[index].removed;
+		edit.inserted = strlen(tc_edits[index].inserted);
+		memmove(text + edit.offset + edit.inserted, text + edit.offset + edit.removed,
+			length - edit.offset - edit.removed);
+		memcpy(text + edit.offset, tc_edits[index].inserted, edit.inserted);
+		length = length - edit.removed + edit.inserted;
+		result = LintJSONIncremental(incremental, &ctx, text, length, &edit);
+		LintJSONIncrementalStats(incremental, &stats);
+		if (length != strlen(tc_edits[index].expected.text) ||
+			memcmp(text, tc_edits[index].expected.text, length) != 0 ||
+			result != tc_edits[index].expected.result || ctx.error != tc_edits[index].expected.error ||
+			(result != RESULT_JSON_LINT_SUCCESS && ctx.offset_invalid_json != tc_edits[index].expected.offset) ||
+			stats.full != tc_edits[index].full || stats.partial != tc_edits[index].partial) {
+			printf("FAIL test %i\r\n", index);
+			test_result = false;
+		}
+		index++;
+	}
+	LintJSONIncrementalFree(incremental);
+	if (test_result) {
+		printf("PASS\r\n");
+	}
+}
+
+/******************************************************************************
+* Function Name:  JSON_Test_Batch
+*
+* Description:
+* This test case checks the result, error, offset, line and column of each
+* document of a batch and the counts of valid and invalid documents, and that
+* a file that can not be read, with either reader, is counted as unread with
+* its errno.
+*
+* Parameters:	None.
+*
+* Return Value:	None.
+*
+* Notes:	None.
+*
+******************************************************************************/
+void JSON_Test_Batch() {
+	json_lint_batch_t batch;
+	json_lint_batch_result_t results[MAIN_BATCH_SIZE];
+	json_lint_location_t location;
+	uint8_t texts[MAIN_BATCH_SIZE][MAIN_TEXT_SIZE];
+	uint8_t *pointers[MAIN_BATCH_SIZE];
+	size_t lengths[MAIN_BATCH_SIZE];
+	bool test_result;
+
+	printf("Batch cases:  ");
+	for (size_t index = 0; index < MAIN_BATCH_SIZE; index++) {
+		lengths[index] = strlen(tc_batch[index].text);
+		memcpy(texts[index], tc_batch[index].text, lengths[index]);
+		pointers[index] = texts[index];
+	}
+	LintJSONBatchInit(&batch);
+	batch.threads = MAIN_BATCH_THREADS;
+	test_result = (LintJSONBatch(&batch, pointers, lengths, MAIN_BATCH_SIZE, results) == RESULT_JSON_LINT_INVALID &&
+		batch.valid == 2 && batch.invalid == 2 && batch.unread == 0);
+	for (size_t index = 0; test_result && index < MAIN_BATCH_SIZE; index++) {
+		memset(&location, 0, sizeof(location));
+		if (results[index].result != RESULT_JSON_LINT_SUCCESS) {
+			LintJSONLocate(texts[index], tc_batch[index].offset, &location);
+		}
+		test_result = (results[index].result == tc_batch[index].result &&
+			results[index].error == tc_batch[index].error &&
+			results[index].offset_invalid_json == tc_batch[index].offset &&
+			results[index].line == location.line && results[index].column == location.column &&
+			results[index].length == lengths[index] && results[index].read_error == 0);
+	}
+	for (uint8_t pass = 0; test_result && pass < 2; pass++) {
+		LintJSONBatchInit(&batch);
+		batch.pread = (pass == 1);
+		test_result = (LintJSONBatchFiles(&batch, &tc_batch_missing, 1, results) == RESULT_JSON_LINT_INVALID &&
+			batch.unread == 1 && batch.valid == 0 && batch.invalid == 0 && results[0].read_error == ENOENT);
+	}
+	printf(test_result ? "PASS\r\n" : "FAIL\r\n");
+}
+
+/******************************************************************************
+* Function Name:  JSON_Check_Case
+*
+* Description:
+* Lint the text of a test case with a context and check the result, error
+* and offset of the invalid json.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context with the options of the case set
+* tc		const tc_case_t *		test case
+* feed		bool					feed the text a byte at a time
+*
+* Return Value:
+* bool		true if the lint gives what the case expects
+*
+* Notes:	None.
+*
+******************************************************************************/
+bool JSON_Check_Case(json_lint_context_t *ctx, const tc_case_t *tc, bool feed) {
+	json_lint_result_t result;
+	uint8_t text[MAIN_TEXT_SIZE];
+	size_t length = strlen(tc->text);
+
+	memcpy(text, tc->text, length);
+	if (feed) {
+		result = JSON_Feed(ctx, text, length, 1, 1);
+	} else {
+		result = LintJSONContext(ctx, text, length);
+	}
+	return (result == tc->result && ctx->error == tc->error &&
+		(result == RESULT_JSON_LINT_SUCCESS || ctx->offset_invalid_json == tc->offset));
+}
+
+/******************************************************************************
+* Function Name:  JSON_Feed
+*
+* Description:
+* Lint a text with LintJSONFeed(), a first chunk and then chunks of a fixed
+* size.
+*
+* Parameters:
+* ctx		json_lint_context_t *	context with its options set
+* text		uint8_t *				text to feed
+* length	size_t					number of bytes of text
+* first		size_t					bytes of the first chunk
+* chunk		size_t					bytes of each chunk after the first
+*
+* Return Value:
+* json_lint_result_t	result of LintJSONFinish(), or of the chunk that was
+*						found invalid
+*
+* Notes:	None.
+*
+******************************************************************************/
+json_lint_result_t JSON_Feed(json_lint_context_t *ctx, uint8_t *text, size_t length, size_t first, size_t chunk) {
+	json_lint_result_t result = RESULT_JSON_LINT_INCOMPLETE;
+	size_t offset = 0;
+	size_t size = (first < length) ? first : length;
+
+	LintJSONBegin(ctx);
+	while (result == RESULT_JSON_LINT_INCOMPLETE && offset < length) {
+		result = LintJSONFeed(ctx, text + offset, size);
+		offset += size;
+		size = (length - offset < chunk) ? length - offset : chunk;
+	}
+	if (result == RESULT_JSON_LINT_INCOMPLETE) {
+		result = LintJSONFinish(ctx);
+	}
+	return result;
+}
+
+/******************************************************************************
+* Function Name:  JSON_Print_Error
+*
+* Description:
+* Print the line, column and reason of an error, and the text each side of it
+* with an indicator under the error.
+*
+* Parameters:
+* text		uint8_t *			JSON string
+* length	size_t				length of the JSON string
+* location	json_lint_location_t *	location of the error
+* error		json_lint_error_t	reason of the error
+*
+* Return Value:	None.
+*
+* Notes:
+* The text shown stays on the line of the error.
+*
+******************************************************************************/
+void JSON_Print_Error(uint8_t *text, size_t length, json_lint_location_t *location, json_lint_error_t error) {
+	uint8_t error_text[2 * MAIN_ERROR_WINDOW + 2] = { 0 };
+	uint8_t error_indicator[MAIN_ERROR_WINDOW + 2] = { 0 };
+	size_t error_start = location->offset - location->line_offset;
+	size_t error_end = 0;
+	size_t i;
+
+	if (error_start > MAIN_ERROR_WINDOW) {
+		error_start = MAIN_ERROR_WINDOW;
+	}
+	while (error_end < MAIN_ERROR_WINDOW && location->offset + error_end < length &&
+		text[location->offset + error_end] != '\n') {
+		error_end++;
+	}
+	memcpy(error_text, &text[location->offset - error_start], error_start + error_end);
+	for (i = 0; i < error_start; i++) {
+		error_indicator[i] = '_';
+	}
+	error_indicator[i] = '^';
+	printf("Error, line %zu column %zu, %s\r\n", location->line, location->column, LintJSONErrorString(error));
+	printf("  issue found at: %s\r\n", error_text);
+	printf("                  %s\r\n", error_indicator);
+}